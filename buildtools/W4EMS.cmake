@@ -50,6 +50,11 @@ set(SHIPPING_LNK
     "-s MAXIMUM_MEMORY=4096MB"
 )
 
+# wasm simd128 kernels of w4::math (impl/W4MathSimd.h), needs a browser with WebAssembly SIMD
+if(W4_WASM_SIMD OR DEFINED ENV{W4_WASM_SIMD})
+    list(APPEND COMMON_CXX "-msimd128")
+endif()
+
 list(JOIN COMMON_CXX    " " COMMON_CXX_STR)
 list(JOIN DEBUG_CXX     " " DEBUG_CXX_STR)
 list(JOIN RELEASE_CXX   " " RELEASE_CXX_STR)
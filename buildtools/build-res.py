@@ -105,7 +105,87 @@ class W4Package:
         })
         array.extend(data)
 
-    def save(self, output_path: Path):
+    # chunked format: packed files are split into independently compressed LZMA2 blocks,
+    # so the runtime decompresses only the blocks that cover the requested file
+    MAGIC_LEGACY = 100500
+    MAGIC_CHUNKED = 100501
+    BLOCK_SIZE = 256 * 1024
+    DICT_SIZE = 1 << 20
+
+    @staticmethod
+    def lzma2_dict_prop(dict_size: int):
+        # LZMA2 dictionary property byte: size = (2 | (prop & 1)) << (prop / 2 + 11)
+        for prop in range(40):
+            if ((2 | (prop & 1)) << (prop // 2 + 11)) >= dict_size:
+                return prop
+        return 40
+
+    def save(self, output_path: Path, chunked: bool = False):
+        if not chunked:
+            self.save_legacy(output_path)
+            return
+
+        logger.debug(f'writing {output_path}')
+        header_bin_io = binio.new("""
+                    1 : uint32          : magic
+                    1 : uint32          : blockSize
+                    1 : uint32          : dictProp
+                    1 : uint32          : NBlocks
+                    1 : uint32          : decomptSize
+                    1 : uint32          : NPackedFiles
+                    1 : uint32          : NRawFiles
+        """)
+
+        file_descr_io = binio.new("""
+                    1 : uint32          : fnsz
+                 fnsz : string@utf8     : fileName
+                    1 : uint32          : mimesz
+               mimesz : string@utf8     : mimeType
+                    1 : uint32          : offset
+                    1 : uint32          : size
+        """)
+
+        block_descr_io = binio.new("""
+                    1 : uint32          : comprOffset
+                    1 : uint32          : comprSize
+        """)
+
+        filters = [{'id': lzma.FILTER_LZMA2, 'preset': lzma.PRESET_DEFAULT, 'dict_size': self.DICT_SIZE}]
+        data = bytes(self.pack_data_array)
+        blocks = []
+        compressed_data = bytearray()
+        for begin in range(0, len(data), self.BLOCK_SIZE):
+            block = lzma.compress(data[begin:begin + self.BLOCK_SIZE], format=lzma.FORMAT_RAW, filters=filters)
+            blocks.append({'comprOffset': len(compressed_data), 'comprSize': len(block)})
+            compressed_data.extend(block)
+
+        header = {
+            'magic': self.MAGIC_CHUNKED,
+            'blockSize': self.BLOCK_SIZE,
+            'dictProp': self.lzma2_dict_prop(self.DICT_SIZE),
+            'NBlocks': len(blocks),
+            'decomptSize': len(data),
+            'NPackedFiles': len(self.pack_data_header),
+            'NRawFiles': len(self.raw_data_header)
+        }
+
+        logger.spam('header\n' + pprint.pformat(header))
+
+        with output_path.open("wb") as pack_file:
+            header_bin_io.write_dict(pack_file, header)
+            for f_descr in self.pack_data_header:
+                file_descr_io.write_dict(pack_file, f_descr)
+
+            for f_descr in self.raw_data_header:
+                file_descr_io.write_dict(pack_file, f_descr)
+
+            for b_descr in blocks:
+                block_descr_io.write_dict(pack_file, b_descr)
+
+            pack_file.write(compressed_data)
+            pack_file.write(self.raw_data_array)
+
+    def save_legacy(self, output_path: Path):
         logger.debug(f'writing {output_path}')
         header_bin_io = binio.new("""
                     1 : uint32          : magic
@@ -129,7 +209,7 @@ class W4Package:
                                         preset=lzma.PRESET_DEFAULT)
 
         header = {
-            'magic': 100500,
+            'magic': self.MAGIC_LEGACY,
             'comprSize': len(compressed_data),
             'decomptSize': len(self.pack_data_array),
             'NPackedFiles': len(self.pack_data_header),
@@ -166,7 +246,8 @@ def make_package(root_dir: Path, output: Path):
             package.add_file(fullpath, archive_path,
                              do_pack=need_pack(fullpath))
 
-    package.save(output)
+    # the engine loader reads the legacy format only, chunked packs are for PackageReader
+    package.save(output, chunked=os.getenv('W4_PACK_CHUNKED') is not None)
 
 def run_asset_creator(*args):
     assert W4_NATIVE_TOOLS != Path()
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+
+#include "W4Math.h"
+#include "BoundingVolume.h"
+
+namespace w4::core {
+
+/*
+ * AABBTree - dynamic bounding volume hierarchy over world space Bounds
+ *      - leaves keep "fat" bounds (enlarged by margin), so small moves leave the tree untouched
+ *      - insertion picks the cheapest sibling by surface area, the tree is kept balanced by rotations
+ *      - rebuild() makes a top-down median split tree, use it after big structure changes
+ *      - proxy ids are stable until remove()
+ * */
+template<typename T>
+class AABBTree
+{
+public:
+    using ProxyId = int32_t;
+    static constexpr ProxyId Null = -1;
+
+    struct Stats
+    {
+        uint32_t tested = 0;    // tree nodes tested against the volume
+        uint32_t culled = 0;    // leaves rejected, including whole rejected subtrees
+        uint32_t accepted = 0;  // leaves passed to the callback
+    };
+
+    explicit AABBTree(float margin = 0.1f);
+
+    ProxyId insert(const Bounds& bounds, T data);
+    void remove(ProxyId id);
+    // returns true if the leaf left its fat bounds and was reinserted
+    bool move(ProxyId id, const Bounds& bounds);
+    void rebuild();
+    void clear();
+
+    T getData(ProxyId id) const;
+    const Bounds& getFatBounds(ProxyId id) const;
+    size_t size() const;
+    int32_t getHeight() const;
+
+    // callback: bool(ProxyId, T) - return false to stop
+    template<typename Callback>
+    void query(const Bounds& bounds, Callback&& callback) const;
+
+    // callback: void(T, bool fullyInside); subtrees fully inside the frustum are accepted without further tests
+    template<typename Callback>
+    Stats queryFrustum(const math::Frustum& frustum, Callback&& callback) const;
+
+    // depth first over the subtrees the ray enters, at each node the child the ray enters first is visited first;
+    // leaves are not globally ordered by distance, a closest hit query shrinks the max distance to prune the rest
+    // callback: float(ProxyId, T, float entryDistance) - returns the new max distance:
+    // the hit distance for a closest hit query, the same maxDistance to visit every leaf, a negative value to stop
+    template<typename Callback>
+    void raycast(const math::Ray& ray, float maxDistance, Callback&& callback) const;
+
+    static bool overlaps(const Bounds& lh, const Bounds& rh);
+    static bool contains(const Bounds& outer, const Bounds& inner);
+    static Bounds merge(const Bounds& lh, const Bounds& rh);
+    static float area(const Bounds& bounds);
+
+private:
+    enum class Classification
+    {
+        Outside,
+        Intersect,
+        Inside
+    };
+
+    struct TreeNode
+    {
+        Bounds bounds;
+        T data{};
+        union
+        {
+            ProxyId parent;
+            ProxyId next;
+        };
+        ProxyId child1 = Null;
+        ProxyId child2 = Null;
+        int32_t height = -1;
+
+        bool isLeaf() const { return child1 == Null; }
+    };
+
+    ProxyId allocateNode();
+    void freeNode(ProxyId id);
+
+    void insertLeaf(ProxyId leaf);
+    void removeLeaf(ProxyId leaf);
+    void refitAncestors(ProxyId id);
+    ProxyId balance(ProxyId id);
+    ProxyId buildTopDown(ProxyId* leaves, size_t count);
+
+    template<typename Callback>
+    void acceptSubtree(ProxyId id, Stats& stats, Callback& callback) const;
+
+    static Classification classify(const Bounds& bounds, const math::Frustum& frustum);
+    static bool intersectRay(const Bounds& bounds, const math::vec3& origin, const math::vec3& invDirection, float maxDistance, float& entry);
+
+private:
+    std::vector<TreeNode> m_nodes;
+    ProxyId m_root = Null;
+    ProxyId m_freeList = Null;
+    size_t m_leavesCount = 0;
+    float m_margin;
+
+    mutable std::vector<ProxyId> m_stack;
+    mutable std::vector<std::pair<ProxyId, float>> m_rayStack;
+};
+
+#include "impl/AABBTree.inl"
+
+} // namespace w4::core
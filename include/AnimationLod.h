@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+
+#include "W4Math.h"
+#include "BoneIndex.h"
+#include "SkeletonPose.h"
+
+namespace w4::render {
+
+/*
+ * AnimationLod - how often and how much of a skinned mesh animation is evaluated
+ *      - levels are ordered near to far, a level is reached by distance or by screen size, whichever comes first
+ *      - a level evaluates the pose every interval frames, the frames in between are interpolated
+ *      - maxBones caps the bones sampled at the level, the rest keep their last local transform
+ *      - meshes out of the frustum are not evaluated at all
+ *      - update phases are spread between meshes, so a crowd does not evaluate on the same frame
+ *      - it only decides: SkinnedMesh animates as before, the caller samples its own poses and shows
+ *        PoseInterpolator::at(decision.alpha) on every Evaluate and Interpolate frame
+ * */
+class AnimationLod
+{
+public:
+    struct Level
+    {
+        float distance = 0.f;       // reached at distance >= this
+        float screenSize = 0.f;     // or at screen size (fraction of the screen height) <= this
+        uint32_t interval = 1;
+        resources::BoneIndex maxBones = resources::maxBonesCount;
+    };
+
+    enum class Action
+    {
+        Evaluate,       // sample and blend the pose
+        Interpolate,    // blend between the last two evaluated poses
+        Skip            // culled, nothing to do
+    };
+
+    struct Decision
+    {
+        Action action = Action::Evaluate;
+        size_t level = 0;
+        // position between the last two pushed poses; on Evaluate frames 0 when the new pose was sampled ahead,
+        // so the pose targeted for this frame is shown rather than the look-ahead one, 1 when it is the current pose
+        float alpha = 1.f;
+        float lookAhead = 0.f;      // Evaluate: the pose is sampled this many frames ahead
+        resources::BoneIndex maxBones = resources::maxBonesCount;
+    };
+
+    struct Counters
+    {
+        uint32_t evaluated = 0;
+        uint32_t interpolated = 0;
+        uint32_t skipped = 0;
+        uint32_t bonesEvaluated = 0;
+    };
+
+    AnimationLod();
+    explicit AnimationLod(std::vector<Level> levels);
+
+    void setLevels(std::vector<Level> levels);
+    const std::vector<Level>& getLevels() const;
+    void setPhase(uint32_t phase);
+
+    size_t selectLevel(float distance, float screenSize) const;
+    // once per frame per mesh, updates the frame counters
+    Decision update(float distance, float screenSize, bool isVisible, uint64_t frame);
+
+    // projected height of a sphere as a fraction of the viewport height
+    static float getScreenSize(float radius, float distance, float fovY);
+
+    // frame counters, beginFrame() moves the current ones to getLastFrameCounters()
+    static void beginFrame();
+    static void addEvaluatedBones(uint32_t count);
+    static const Counters& getFrameCounters();
+    static const Counters& getLastFrameCounters();
+
+private:
+    std::vector<Level> m_levels;
+    uint32_t m_phase = 0;
+    uint64_t m_lastEvaluatedFrame = std::numeric_limits<uint64_t>::max();
+    uint32_t m_lastInterval = 1;
+
+    static Counters m_frameCounters;
+    static Counters m_lastFrameCounters;
+};
+
+/*
+ * PoseInterpolator - keeps the last two evaluated local poses of a throttled mesh
+ *      - push() the pose sampled lookAhead frames ahead on evaluation frames
+ *      - at(alpha) blends from the previous pose to it on the frames in between
+ * */
+class PoseInterpolator
+{
+public:
+    void push(const resources::LocalPose& pose);
+    const resources::LocalPose& at(float alpha);
+    void reset();
+    bool isEmpty() const;
+
+private:
+    resources::LocalPose m_from;
+    resources::LocalPose m_to;
+    resources::LocalPose m_result;
+    bool m_hasFrom = false;
+    bool m_hasTo = false;
+};
+
+#include "impl/AnimationLod.inl"
+
+} // namespace w4::render
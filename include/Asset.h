@@ -17,6 +17,7 @@ class Asset: public w4::core::Object, public w4::core::Cache<Asset>
 {
     W4_OBJECT(Asset, w4::core::Object);
 public:
+    // blocks until the whole asset is loaded, AssetLoader queues loads and the work that follows them over frames
     static sptr<Asset> load(const std::string& path);
     bool save(const std::string& path) const;
 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+
+#include "Asset.h"
+
+namespace w4::resources {
+
+/*
+ * AssetLoadTask - one Asset load followed by the caller's own steps, spread over frames
+ *      - the first step is Asset::load: the engine parses the asset format, so reading, decompressing and
+ *        registering the file is one blocking step that cannot be split or interrupted
+ *      - addStep() queues the caller's work that needs the asset (clones, material setup, warm-up draws),
+ *        those steps are what actually spreads over frames
+ *      - cancel() stops at the next step boundary, the completion callback fires exactly once
+ * */
+class AssetLoadTask
+{
+public:
+    enum class State
+    {
+        Queued,
+        Processing,
+        Completed,
+        Failed,
+        Cancelled
+    };
+
+    struct Progress
+    {
+        uint32_t stepsDone = 0;
+        uint32_t stepsTotal = 0;
+
+        float getFraction() const;
+    };
+
+    // returns false on failure
+    using Step = std::function<bool()>;
+    using ProgressCallback = std::function<void(const Progress&)>;
+    using CompleteCallback = std::function<void(const sptr<Asset>&, State)>;
+
+    AssetLoadTask(const std::string& path, const CompleteCallback& onComplete, const ProgressCallback& onProgress);
+
+    const std::string& getPath() const;
+    State getState() const;
+    const Progress& getProgress() const;
+    bool isFinished() const;
+    // nullptr until the load step ran
+    const sptr<Asset>& getAsset() const;
+
+    // runs after the asset is loaded, in the order of the calls
+    void addStep(const Step& step);
+    void cancel();
+
+    // runs steps until the deadline, at least one when force is set; returns true when the task is finished
+    bool run(std::chrono::steady_clock::time_point deadline, bool force);
+
+private:
+    bool load();
+    void finish(State state);
+
+private:
+    std::string m_path;
+    CompleteCallback m_onComplete;
+    ProgressCallback m_onProgress;
+
+    State m_state = State::Queued;
+    Progress m_progress;
+    std::deque<Step> m_steps;
+    sptr<Asset> m_asset;
+    bool m_isCancelRequested = false;
+};
+
+/*
+ * AssetLoader - queue of AssetLoadTask ticked once per frame
+ *      - the game calls AssetLoader::update() every frame, e.g. from IGame::onUpdate
+ *      - steps run in submission order until the per-frame time budget is spent, at least one step per update,
+ *        so a frame is over budget by one step at most, e.g. one Asset::load
+ *      - finished assets are added to Cache<Asset>, so a later Asset::get returns them immediately
+ * */
+class AssetLoader
+{
+public:
+    static sptr<AssetLoadTask> load(const std::string& path,
+                                    const AssetLoadTask::CompleteCallback& onComplete,
+                                    const AssetLoadTask::ProgressCallback& onProgress = {});
+    static void update();
+    static void cancelAll();
+
+    static void setFrameBudget(float milliseconds);
+    static float getFrameBudget();
+    static size_t getPendingCount();
+
+private:
+    inline static std::vector<sptr<AssetLoadTask>> m_tasks;
+    inline static float m_frameBudget = 4.f;
+};
+
+#include "impl/AssetLoader.inl"
+
+} // namespace w4::resources
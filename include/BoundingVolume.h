@@ -154,19 +154,14 @@ public:
 
     std::array<math::vec3, 8> getPoints(const math::Transform& transform) const
     {
-        const auto& n = min();
-        const auto& p = max();
+        return getPoints(transform.getMatrix());
+    }
 
-        return {
-                math::vec3{n.x, n.y, n.z}.localToWorld(transform),
-                math::vec3{n.x, n.y, p.z}.localToWorld(transform),
-                math::vec3{n.x, p.y, n.z}.localToWorld(transform),
-                math::vec3{n.x, p.y, p.z}.localToWorld(transform),
-                math::vec3{p.x, n.y, n.z}.localToWorld(transform),
-                math::vec3{p.x, n.y, p.z}.localToWorld(transform),
-                math::vec3{p.x, p.y, n.z}.localToWorld(transform),
-                math::vec3{p.x, p.y, p.z}.localToWorld(transform)
-        };
+    std::array<math::vec3, 8> getPoints(const math::mat4& transform) const
+    {
+        auto result = getPoints();
+        math::transformPoints(transform, result.data(), result.data(), result.size());
+        return result;
     }
 
 private:
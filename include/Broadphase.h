@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <functional>
+
+#include "W4Math.h"
+#include "BoundingVolume.h"
+
+namespace w4::core {
+
+/*
+ * SweepAndPrune - broadphase over world space Bounds
+ *      - proxies are kept sorted by min.x, the order is repaired with insertion sort,
+ *        which is close to linear for frame-to-frame coherent motion
+ *      - each proxy carries group bits, findPairs reports (source, target) candidates where
+ *        one proxy belongs to sourceGroups and the other to targetGroups
+ * */
+template<typename T>
+class SweepAndPrune
+{
+public:
+    using ProxyId = uint32_t;
+    static constexpr ProxyId Null = std::numeric_limits<ProxyId>::max();
+
+    ProxyId add(T data, const Bounds& bounds, uint8_t groups);
+    void remove(ProxyId id);
+    void update(ProxyId id, const Bounds& bounds);
+    void setGroups(ProxyId id, uint8_t groups);
+    uint8_t getGroups(ProxyId id) const;
+    void clear();
+
+    size_t size() const;
+
+    // callback: void(T source, T target)
+    template<typename Callback>
+    void findPairs(uint8_t sourceGroups, uint8_t targetGroups, Callback&& callback);
+
+private:
+    struct Proxy
+    {
+        Bounds bounds;
+        T data{};
+        uint8_t groups = 0;
+        bool isAlive = false;
+    };
+
+    void sortAxis();
+
+private:
+    std::vector<Proxy> m_proxies;
+    std::vector<ProxyId> m_free;
+    std::vector<ProxyId> m_order;
+    std::vector<ProxyId> m_sweep;
+    size_t m_count = 0;
+    bool m_hasRemoved = false;
+};
+
+/*
+ * PairTable - flat table of values keyed by ordered pairs
+ *      - values live in one contiguous array, lookup goes through an open addressing index
+ *      - erase() moves the last value into the freed place, so it is O(1) and does not keep the order
+ *      - retain() walks values in memory order and drops the rejected ones in bulk
+ * */
+template<typename T, typename V>
+class PairTable
+{
+public:
+    struct Entry
+    {
+        T first;
+        T second;
+        V value;
+    };
+
+    V& operator()(T first, T second);
+    V* find(T first, T second);
+    void erase(T first, T second);
+
+    // callback: bool(Entry&) - return false to drop the entry
+    template<typename Callback>
+    void retain(Callback&& callback);
+
+    // drops every pair containing the object
+    void eraseAll(T object);
+
+    void clear();
+    size_t size() const;
+
+private:
+    static size_t hash(T first, T second);
+    int32_t findIndex(T first, T second) const;
+    int32_t findSlot(T first, T second) const;
+    void eraseSlot(size_t slot);
+    void rebuildIndex(size_t capacity);
+
+private:
+    std::vector<Entry> m_entries;
+    std::vector<int32_t> m_index;
+};
+
+#include "impl/Broadphase.inl"
+
+} // namespace w4::core
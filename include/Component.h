@@ -2,6 +2,7 @@
 
 #include "Variant.h"
 #include "TypeInfo.h"
+#include "ComponentPool.h"
 
 #include "Nodes/DebugView.h"
 
@@ -11,6 +12,7 @@
 
 #define W4_COMPONENT(T, S) __W4_COMPONENT(T, S)
 #define W4_COMPONENT_DISABLE_CLONING __W4_COMPONENT_DISABLE_CLONING
+#define W4_COMPONENT_POOLED __W4_COMPONENT_POOLED
 
 namespace w4::core {
 
@@ -96,6 +98,16 @@ public:
     template<typename T>
     static void onComponentAdded(IComponent::RegisterTag, T * component);
 
+    // W4_COMPONENT_POOLED components of exactly type T, enabled ones in memory order; f(T&) is called without dispatch
+    // pooled components are still updated by update() like any other, forEach is for the app's own typed passes
+    template<typename T, typename F>
+    static void forEach(F&& f);
+
+    template<typename T>
+    static ComponentHandle<T> getHandle(const T& component);
+    template<typename T>
+    static T* get(const ComponentHandle<T>& handle);
+
 private:
     friend class IComponent;
     static void onComponentRemoved(IComponent * component);
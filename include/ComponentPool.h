@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <new>
+
+#include "FatalError.h"
+
+namespace w4::core {
+
+template<typename T>
+struct ComponentHandle
+{
+    static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != InvalidIndex; }
+    bool operator==(const ComponentHandle& rh) const { return index == rh.index && generation == rh.generation; }
+    bool operator!=(const ComponentHandle& rh) const { return !operator==(rh); }
+};
+
+/*
+ * ComponentPool - storage of all the components of one exact type, see W4_COMPONENT_POOLED
+ *      - components are allocated in chunks of ChunkSize slots, they never move, freed slots are reused first
+ *      - forEach() walks the slots in memory order, no hashing and no virtual call
+ *      - a slot generation is bumped when it is freed, so a stale ComponentHandle resolves to nullptr
+ * */
+template<typename T>
+class ComponentPool
+{
+public:
+    static constexpr size_t ChunkSize = 256;
+
+    static ComponentPool& instance();
+
+    // operator new / delete of the component, sizes other than sizeof(T) go to the global heap
+    void* allocate(size_t size);
+    void deallocate(void* ptr, size_t size);
+
+    ComponentHandle<T> getHandle(const T& component) const;
+    // nullptr once the component is destroyed
+    T* get(const ComponentHandle<T>& handle) const;
+
+    // f(T&) for every live component, in memory order
+    template<typename F>
+    void forEach(F&& f);
+
+    size_t size() const;
+    size_t capacity() const;
+
+private:
+    struct alignas(T) Slot
+    {
+        unsigned char storage[sizeof(T)];
+    };
+
+    ComponentPool() = default;
+    T* slot(uint32_t index) const;
+    uint32_t findIndex(const void* ptr) const;
+
+private:
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    std::vector<std::pair<const Slot*, uint32_t>> m_chunksByAddress;
+    std::vector<uint32_t> m_generations;
+    std::vector<uint8_t> m_alive;
+    std::vector<uint32_t> m_free;
+    size_t m_size = 0;
+};
+
+#include "impl/ComponentPool.inl"
+
+} // namespace w4::core
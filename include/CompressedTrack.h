@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <cstring>
+#include <cmath>
+
+#include "Track.h"
+
+namespace w4::resources {
+
+// component layout of track values for CompressedTrack
+template<typename T>
+struct TrackKeyCodec;
+
+template<>
+struct TrackKeyCodec<float>
+{
+    static constexpr size_t Floats = 1;
+    static constexpr size_t Words = 1;
+    static constexpr bool IsRotation = false;
+
+    static void split(const float& value, float* out) { out[0] = value; }
+    static float join(const float* in) { return in[0]; }
+};
+
+template<>
+struct TrackKeyCodec<math::vec3>
+{
+    static constexpr size_t Floats = 3;
+    static constexpr size_t Words = 3;
+    static constexpr bool IsRotation = false;
+
+    static void split(const math::vec3& value, float* out) { out[0] = value.x; out[1] = value.y; out[2] = value.z; }
+    static math::vec3 join(const float* in) { return {in[0], in[1], in[2]}; }
+};
+
+template<>
+struct TrackKeyCodec<math::Rotator>
+{
+    static constexpr size_t Floats = 4;
+    static constexpr size_t Words = 3;
+    static constexpr bool IsRotation = true;
+
+    static void split(const math::Rotator& value, float* out);
+    static math::Rotator join(const float* in);
+    // "smallest three": index of the dropped component in 2 bits, the other three in 15 bits each, its sign in the last bit
+    static void encode(const float* quaternion, uint16_t* words);
+    static void decode(const uint16_t* words, float* quaternion);
+};
+
+/*
+ * CompressedTrack - quantized copy of the keys of a Track<T>, decoded one key at a time
+ *      - built from Track::getValues() by whoever samples it; the Track and its Animator keep using the plain keys
+ *      - uniformly sampled keys keep no times (start + index * step), others keep 16-bit fractions of the span
+ *      - values are 16 bits per component in the track range, rotations 48 bits ("smallest three")
+ *      - one interpolation type per track when all keys agree, a byte per key otherwise
+ *      - tangents are kept, at full precision, only for keys next to a HERMIT segment
+ * */
+template<typename T>
+class CompressedTrack
+{
+public:
+    using Value = TrackValue<T>;
+    using Codec = TrackKeyCodec<T>;
+
+    struct Options
+    {
+        float timeTolerance = 0.01f;    // max deviation from uniform keys for implied times, in steps
+    };
+
+    static CompressedTrack compress(const std::vector<Value>& values, const Options& options = Options());
+    std::vector<Value> decompress() const;
+
+    size_t size() const;
+    bool empty() const;
+    bool isUniform() const;
+
+    float getTime(size_t index) const;
+    T getValue(size_t index) const;
+    InterpType getInterp(size_t index) const;
+    Value getKey(size_t index) const;
+    // index of the first key after time
+    size_t upperBound(float time) const;
+    // same result as Track::sample() on the source keys, up to the quantization error
+    T sample(float time) const;
+
+    size_t getMemorySize() const;
+
+    size_t binarySize() const;
+    size_t toBinary(void* destination, size_t bufferSize) const;
+    void fromBinary(const void* source, size_t bufferSize);
+
+private:
+    static constexpr uint32_t NoTangents = std::numeric_limits<uint32_t>::max();
+
+    uint32_t getTangentsSlot(size_t index) const;
+    Value getKeyByOffset(size_t index, int offset) const;
+
+private:
+    uint32_t m_count = 0;
+    float m_startTime = 0.f;
+    float m_step = 0.f;         // uniform keys
+    float m_span = 0.f;         // 16-bit times
+    std::vector<uint16_t> m_times;
+
+    std::vector<uint16_t> m_values;
+    std::array<float, Codec::Floats> m_rangeMin{};
+    std::array<float, Codec::Floats> m_rangeScale{};
+
+    InterpType m_interp = InterpType::LERP;
+    std::vector<uint8_t> m_interps;
+
+    bool m_allTangents = false;
+    std::vector<uint32_t> m_tangentsSlots;
+    std::vector<float> m_tangents;  // 2 * Codec::Floats per slot
+};
+
+} // namespace w4::resources
+
+#include "impl/CompressedTrack.inl"
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "Input.h"
+
+namespace w4::platform {
+
+/*
+ * InputCoalescer - merges high frequency input into one update per finger and per axis a frame
+ *      - the engine dispatches every event as before, the app calls on*() from its own handlers and flushes once per frame
+ *      - the moves of a finger are merged until the next flushTouchMoves(), their raw points are kept for gesture code
+ *      - onTouchBegin() and onTouchEnd() deliver the moves still buffered for that touch id first, so the handler sees
+ *        them before the app handles the Begin or End itself
+ *      - an axis is reported by flushAxis() only when its value changed since the last flush
+ *      - gamepad axes are not events but a GAMEPAD_DATA snapshot refreshed by the platform, flushGamepadAxes() reads it once
+ *        and reports the axes that moved since the last flush
+ * */
+class InputCoalescer
+{
+public:
+    // points are the merged raw points oldest first, point is the last of them
+    using TouchMovesHandler = std::function<void(int touchId, const math::point& point, const std::vector<math::point>& points)>;
+
+    explicit InputCoalescer(TouchMovesHandler onTouchMoves);
+
+    void onTouchBegin(const event::Touch::Begin& event);
+    void onTouchMove(const event::Touch::Move& event);
+    void onTouchEnd(const event::Touch::End& event);
+    // AxisEvent is one of the Joystick *Axis events
+    template<typename AxisEvent>
+    void onAxis(const AxisEvent& event);
+
+    // the handler once per finger moved since the last flush
+    void flushTouchMoves();
+    // f(const AxisEvent&) with the latest value, when it differs from the one flushed last time
+    template<typename AxisEvent, typename F>
+    void flushAxis(F&& f);
+    // f(size_t axis, float value) per Input::gamepad() axis changed since the last flush
+    template<typename F>
+    void flushGamepadAxes(F&& f);
+
+    void clear();
+
+    size_t getRawCount() const;
+    size_t getFlushedCount() const;
+
+private:
+    struct Finger
+    {
+        int touchId;
+        std::vector<math::point> points;
+    };
+
+    struct Axis
+    {
+        core::TypeInfo::HashType type;
+        float value;
+        float flushedValue;
+    };
+
+    Finger& getFinger(int touchId);
+    void flushFinger(Finger& finger);
+    Axis& getAxis(core::TypeInfo::HashType type);
+
+private:
+    TouchMovesHandler m_onTouchMoves;
+    std::vector<Finger> m_fingers;
+    std::vector<Axis> m_axes;
+    std::array<float, MAX_GAMEPAD_AXES> m_gamepadAxes;
+    size_t m_rawCount = 0;
+    size_t m_flushedCount = 0;
+};
+
+#include "impl/InputCoalescer.inl"
+
+} // namespace w4::platform
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+
+#include "W4Common.h"
+#include "FileStream.h"
+#include "Resource.h"
+#include "external/LzmaDec.h"
+#include "external/Lzma2Dec.h"
+
+namespace w4::resources {
+
+/*
+ * PackageReader - random access to files of a .w4pack
+ *      - chunked packs (build-res.py with W4_PACK_CHUNKED=1) are split into independently compressed LZMA2 blocks,
+ *        a read decompresses only the blocks covering the requested file
+ *      - decoded blocks are kept in a small LRU cache, so neighbouring files reuse them
+ *      - legacy packs are a single LZMA blob, it is decoded as one block on the first packed read
+ * */
+class PackageReader
+{
+public:
+    struct File
+    {
+        std::string name;
+        std::string mimeType;
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        bool isPacked = false;
+    };
+
+    struct Stats
+    {
+        uint32_t blocksDecoded = 0;
+        uint32_t cacheHits = 0;
+        uint64_t bytesDecoded = 0;
+    };
+
+    explicit PackageReader(size_t cachedBlocks = 4);
+
+    bool open(const sptr<filesystem::Stream>& stream);
+    void close();
+    bool isChunked() const;
+
+    const File* find(const std::string& name) const;
+    const std::vector<File>& getFiles() const;
+
+    bool read(const File& file, std::vector<uint8_t>& result);
+    bool read(const std::string& name, std::vector<uint8_t>& result);
+    // reads the asset file the description points to
+    bool readAssetFile(const ResourceFileDescription& description, std::vector<uint8_t>& result);
+
+    const Stats& getStats() const;
+
+private:
+    static constexpr uint32_t MagicLegacy = 100500;
+    static constexpr uint32_t MagicChunked = 100501;
+
+    struct Block
+    {
+        uint32_t comprOffset = 0;
+        uint32_t comprSize = 0;
+    };
+
+    struct CachedBlock
+    {
+        uint32_t index;
+        uint64_t lastUse;
+        std::vector<uint8_t> data;
+    };
+
+    const std::vector<uint8_t>* getBlock(uint32_t index);
+    bool decodeBlock(uint32_t index, std::vector<uint8_t>& result) const;
+    bool parse(const uint8_t* data, size_t size);
+
+private:
+    sptr<filesystem::Stream> m_stream;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+    bool m_isChunked = false;
+    uint32_t m_blockSize = 0;
+    uint8_t m_dictProp = 0;
+    uint32_t m_decompressedSize = 0;
+    size_t m_comprBegin = 0;
+    size_t m_rawBegin = 0;
+
+    std::vector<File> m_files;
+    std::unordered_map<std::string, size_t> m_filesByName;
+    std::vector<Block> m_blocks;
+
+    std::vector<CachedBlock> m_cache;
+    size_t m_cachedBlocks;
+    uint64_t m_useCounter = 0;
+    Stats m_stats;
+};
+
+#include "impl/PackageReader.inl"
+
+} // namespace w4::resources
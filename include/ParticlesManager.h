@@ -0,0 +1,152 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+
+#include "W4Math.h"
+#include "FatalError.h"
+#include "ParticlesSimulation.h"
+#include "Nodes/ParticlesEmitter.h"
+
+namespace w4::render {
+
+/*
+ * ParticlesBatcher - merges the particles of emitters sharing a texture and a BlendFunc
+ *      - vertices of all batches go to one array in world space, a batch is a contiguous range of it
+ *      - particle quads are indexed the same way everywhere, so a batch draws a range of one shared indices buffer
+ * */
+class ParticlesBatcher
+{
+public:
+    struct Batch
+    {
+        resources::Texture* texture;
+        BlendFunc blendFunc;
+        uint32_t firstParticle;
+        uint32_t particlesCount;
+        uint32_t emittersCount;
+    };
+
+    void begin();
+    void add(const ParticlesSimulation& simulation, const math::mat4& world, float depthStep);
+    // groups the emitters and writes their vertices
+    void end();
+
+    const std::vector<Batch>& getBatches() const;
+    const std::vector<ParticlesVertexFormat>& getVertices() const;
+    size_t getParticlesCount() const;
+
+    // quads of particlesCount particles, a batch draws IndicesPerParticle * particlesCount from IndicesPerParticle * firstParticle
+    template<typename Index>
+    static void writeIndices(std::vector<Index>& out, size_t particlesCount);
+
+private:
+    struct Entry
+    {
+        const ParticlesSimulation* simulation;
+        math::mat4 world;
+        float depthStep;
+    };
+
+    static bool isSameBatch(const ParticlesEmitterParameters& a, const ParticlesEmitterParameters& b);
+    static bool isBatchLess(const ParticlesEmitterParameters& a, const ParticlesEmitterParameters& b);
+
+private:
+    std::vector<Entry> m_entries;
+    std::vector<Batch> m_batches;
+    std::vector<ParticlesVertexFormat> m_vertices;
+    size_t m_particlesCount = 0;
+};
+
+/*
+ * ParticlesManager - short lived particle effects without an emitter node each
+ *      - play() takes a simulation from a pool, it goes back once the effect has stopped and its particles are dead
+ *      - effects are merged by ParticlesBatcher into one batch per texture and BlendFunc, the built-in passes do not draw them:
+ *        the app uploads getBatcher().getVertices() to its own buffer and draws a range of it per batch
+ *      - acquireEmitter() reuses released ParticlesEmitter nodes of the same source instead of cloning a new one;
+ *        an emitter is pooled only after releaseEmitter() and once its particles are dead, never just because it went IDLE
+ *      - it only detaches the emitters from the parent it attached them to, an emitter moved elsewhere by the app is left
+ *        there and forgotten rather than pooled
+ *      - update() once per frame, before the frame is rendered
+ * */
+class ParticlesManager
+{
+public:
+    using Parameters = ParticlesEmitterParameters;
+    using EffectId = uint32_t;
+    static constexpr EffectId InvalidEffect = 0;
+
+    struct Stats
+    {
+        uint32_t effects = 0;
+        uint32_t particles = 0;
+        uint32_t batches = 0;
+        uint32_t pooledSimulations = 0;
+        uint32_t emitters = 0;
+        uint32_t pooledEmitters = 0;
+        uint32_t clonedEmitters = 0;    // since the start, the rest were reused
+    };
+
+    static ParticlesManager& instance();
+
+    EffectId play(const Parameters& parameters, const math::mat4& world);
+    void setTransform(EffectId effect, const math::mat4& world);
+    // stops emitting, the effect is removed once its particles are dead
+    void stop(EffectId effect);
+    // removed right away
+    void kill(EffectId effect);
+    bool isAlive(EffectId effect) const;
+
+    // started and added to parent
+    sptr<ParticlesEmitter> acquireEmitter(const resources::ResourceFileDescription& source, cref<core::Node> parent);
+    // stops an emitter got from acquireEmitter(), it goes back to the pool once its particles are dead
+    void releaseEmitter(cref<ParticlesEmitter> emitter);
+
+    void update(float dt);
+    // acquired emitters that are not released stay where they are
+    void clear();
+
+    const ParticlesBatcher& getBatcher() const;
+    Stats getStats() const;
+
+private:
+    struct Effect
+    {
+        EffectId id;
+        uptr<ParticlesSimulation> simulation;
+        math::mat4 world;
+    };
+
+    struct ActiveEmitter
+    {
+        sptr<ParticlesEmitter> emitter;
+        std::string source;
+        wptr<core::Node> parent;    // the one acquireEmitter() added it to
+        bool isReleased = false;
+    };
+
+    static std::string getSourceKey(const resources::ResourceFileDescription& source);
+    Effect* findEffect(EffectId effect);
+    const Effect* findEffect(EffectId effect) const;
+    void removeEffect(size_t index);
+    // detaches the emitter if it is still under the parent it was acquired with, returns false if the app moved it
+    static bool detachEmitter(const ActiveEmitter& active);
+
+private:
+    std::vector<Effect> m_effects;
+    std::unordered_map<EffectId, size_t> m_effectsIndices;
+    std::vector<uptr<ParticlesSimulation>> m_pooledSimulations;
+    EffectId m_nextEffectId = InvalidEffect + 1;
+
+    std::vector<ActiveEmitter> m_emitters;
+    std::unordered_map<std::string, std::vector<sptr<ParticlesEmitter>>> m_pooledEmitters;
+    uint32_t m_clonedEmitters = 0;
+
+    ParticlesBatcher m_batcher;
+};
+
+#include "impl/ParticlesManager.inl"
+
+} // namespace w4::render
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <limits>
+
+#include "W4Math.h"
+#include "PodGenerator.h"
+#include "FatalError.h"
+#include "Nodes/ParticlesEmitterParameters.h"
+#include "impl/W4MathSimd.h"
+
+// a billboard corner, the quad is expanded on the CPU in emitter space (or world space in PARTICLE transform mode)
+POD_STRUCT(ParticlesVertexFormat,
+           POD_FIELD(w4::math::vec3, w4_a_position)
+           POD_FIELD(w4::math::vec4, w4_a_color)
+           POD_FIELD(w4::math::vec2, w4_a_uv)
+);
+
+// a billboard corner of ParticlesGpuStream, written once at spawn, the motion is evaluated in the vertex shader
+POD_STRUCT(ParticlesSpawnVertexFormat,
+           POD_FIELD(w4::math::vec4, w4_a_spawn)            // spawn time, life, slot, corner
+           POD_FIELD(w4::math::vec3, w4_a_origin)           // emitter world position at birth
+           POD_FIELD(w4::math::vec2, w4_a_start)            // position relative to the source
+           POD_FIELD(w4::math::vec4, w4_a_motion)           // GRAVITY: velocity; RADIUS: angle, angle speed, radius, radius speed
+           POD_FIELD(w4::math::vec4, w4_a_sizeRotation)     // size, size speed, rotation, rotation speed
+           POD_FIELD(w4::math::vec4, w4_a_color)
+           POD_FIELD(w4::math::vec4, w4_a_colorSpeed)
+);
+
+namespace w4::render {
+
+/*
+ * ParticlesSpawner - emission rate and the randomized start of new particles, shared by the CPU and GPU paths
+ *      - the pool of maxParticles is refilled over one particle life span, until duration runs out (forever if negative)
+ *      - all the per-particle randomness is drawn here, from a seeded xorshift
+ * */
+class ParticlesSpawner
+{
+public:
+    using Parameters = ParticlesEmitterParameters;
+
+    struct Particle
+    {
+        float x = 0.f;                  // relative to the source position
+        float y = 0.f;
+        float life = 0.f;
+        float size = 0.f;
+        float sizeSpeed = 0.f;
+        float rotation = 0.f;
+        float rotationSpeed = 0.f;
+        float color[4] = {};
+        float colorSpeed[4] = {};
+        float motion[4] = {};           // GRAVITY: velocity, radial and tangential acceleration; RADIUS: angle, angle speed, radius, radius speed
+    };
+
+    void setParameters(const Parameters& parameters);
+
+    void start();
+    void stop();
+    bool isEmitting() const;
+
+    // particles due this frame
+    size_t advance(float dt);
+    Particle spawn();
+
+    void setSeed(uint32_t seed);
+
+private:
+    // uniform in [-1, 1]
+    float random();
+    float vary(const Parameters::Param<float>& param);
+
+private:
+    Parameters m_parameters{};
+    bool m_isEmitting = false;
+    float m_elapsed = 0.f;
+    float m_emitCounter = 0.f;
+    uint32_t m_seed = 0x9e3779b9u;
+};
+
+/*
+ * ParticlesSimulation - particles of one emitter in structure of arrays form
+ *      - every particle attribute is a float channel, channels are padded to whole SIMD lanes
+ *      - GRAVITY particles are integrated four at a time, RADIUS ones in a plain loop over the channels
+ *      - dead particles are compacted in one pass over all the channels after the update, the order of the rest is kept
+ *      - writeVertices() fills a caller owned vertex array (e.g. UserVerticesBuffer::resize()) with 4 vertices per particle
+ *      - ParticlesEmitter does not use it and simulates as before; who updates a ParticlesSimulation also draws its vertices
+ * */
+class ParticlesSimulation
+{
+public:
+    using Parameters = ParticlesEmitterParameters;
+
+    static constexpr size_t VerticesPerParticle = 4;
+    static constexpr size_t IndicesPerParticle = 6;
+
+    enum Channel : size_t
+    {
+        X, Y,                           // relative to the source position
+        OriginX, OriginY, OriginZ,      // emitter world position at birth, PARTICLE transform mode
+        Life,
+        Size, SizeSpeed,
+        Rotation, RotationSpeed,
+        Red, Green, Blue, Alpha,
+        RedSpeed, GreenSpeed, BlueSpeed, AlphaSpeed,
+        VelocityX, VelocityY,           // GRAVITY
+        RadialAcceleration, TangentialAcceleration,
+        Angle, AngleSpeed,              // RADIUS
+        Radius, RadiusSpeed,
+        ChannelsCount
+    };
+
+    void setParameters(const Parameters& parameters);
+    const Parameters& getParameters() const;
+
+    // emitting starts over, live particles are kept
+    void start();
+    void stop();
+    bool isEmitting() const;
+    // all particles are removed
+    void clear();
+
+    // emits, integrates and compacts; world is the emitter world transform
+    void update(float dt, const math::mat4& world);
+
+    size_t size() const;
+    size_t capacity() const;
+    bool hasActiveParticles() const;
+
+    const float* getChannel(Channel channel) const;
+
+    // VerticesPerParticle * size() vertices, returns their count
+    template<typename VertexFormat>
+    size_t writeVertices(VertexFormat* out, float depthStep) const;
+    // same in world space for both transform modes, for batches merging several emitters
+    template<typename VertexFormat>
+    size_t writeVertices(VertexFormat* out, float depthStep, const math::mat4& world) const;
+    // quads of VerticesPerParticle vertices as two triangles, particlesCount * IndicesPerParticle indices
+    template<typename Index>
+    static void writeIndices(Index* out, size_t particlesCount);
+
+    void setSeed(uint32_t seed);
+
+private:
+    float* channel(Channel channel);
+
+    // world: EMITTER transform mode vertices are transformed by it too, left in emitter space when null
+    template<typename VertexFormat>
+    size_t writeVertices(VertexFormat* out, float depthStep, const float* world) const;
+
+    void emit(size_t count);
+    void integrateGravity(float dt);
+    void integrateRadius(float dt);
+    void integrateCommon(float dt);
+    void compact();
+
+private:
+    Parameters m_parameters{};
+    std::array<std::vector<float>, ChannelsCount> m_channels;
+    std::vector<uint32_t> m_survivors;
+    size_t m_size = 0;
+    size_t m_capacity = 0;
+    ParticlesSpawner m_spawner;
+
+    math::mat4 m_world = math::mat4::identity;
+};
+
+/*
+ * ParticlesGpuStream - particles evaluated in the vertex shader from their spawn attributes and w4_u_time
+ *      - the motion has to be a function of the age: GRAVITY without radial or tangential acceleration, or RADIUS
+ *      - maxParticles slots in a ring, a new particle takes the oldest slot once it is dead, dropped otherwise
+ *      - only the slots spawned since the last upload are dirty, so the CPU cost follows the spawn rate
+ *      - dead and unborn slots are moved out of the clip volume by the shader, the whole ring is drawn
+ *      - the CPU side only: no engine material compiles getShaderSource() and nothing falls back to ParticlesSimulation,
+ *        the caller checks isSupported(), builds the shader into its own material and sets the w4_u_particles* uniforms
+ * */
+class ParticlesGpuStream
+{
+public:
+    using Parameters = ParticlesEmitterParameters;
+    using VertexFormat = ParticlesSpawnVertexFormat;
+
+    // false: the motion has no closed form in the age, the caller has to simulate these particles on the CPU
+    static bool isSupported(const Parameters& parameters);
+    // GLSL for the vertex shader, defines bool w4_evaluateParticle(out vec3 position, out vec4 color, out vec2 uv)
+    static const char* getShaderSource();
+
+    void setParameters(const Parameters& parameters);
+    const Parameters& getParameters() const;
+
+    void start();
+    void stop();
+    bool isEmitting() const;
+    void clear();
+
+    // time is the w4_u_time the frame is rendered with
+    void update(float dt, float time, const math::mat4& world);
+
+    size_t capacity() const;
+    bool hasActiveParticles(float time) const;
+    size_t getSpawnedCount() const;     // by the last update
+
+    const VertexFormat* getVertices() const;
+    size_t getVerticesCount() const;
+    bool isDirty() const;
+    // [first, last) changed vertices, may cover the whole ring when the spawned slots wrap around
+    std::pair<size_t, size_t> getDirtyVertices() const;
+    void clearDirty();
+
+    // w4_u_particlesFlags: emitter type, rotation follows the velocity, world origins, flipped v
+    math::vec4 getShaderFlags() const;
+
+    void setSeed(uint32_t seed);
+
+private:
+    void markDirty(size_t first, size_t last);
+
+private:
+    Parameters m_parameters{};
+    ParticlesSpawner m_spawner;
+    std::vector<VertexFormat> m_vertices;
+    std::vector<float> m_deathTimes;
+    size_t m_head = 0;
+    size_t m_spawnedCount = 0;
+    float m_lastDeathTime = 0.f;
+    size_t m_dirtyFirst = 0;
+    size_t m_dirtyLast = 0;
+};
+
+#include "impl/ParticlesSimulation.inl"
+
+} // namespace w4::render
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "AABBTree.h"
+#include "Collider.h"
+
+namespace w4::core {
+
+/*
+ * RaycastTree - AABBTree over the world bounds of colliders, for closest hit queries and batches of rays
+ *      - colliders are added by the app and refit with update() after their node moved,
+ *        the engine's own raycast list and Render::raycast are left as they are
+ *      - a ray only tests the colliders whose bounds it crosses, the hit itself is Collider::intersect(ray)
+ *      - hits are ranked by CollisionInfo::distance like Render::raycastAll; that distance is not the ray entry,
+ *        so every crossed collider is tested rather than pruning subtrees behind the best hit
+ * */
+class RaycastTree
+{
+public:
+    explicit RaycastTree(float margin = 0.1f);
+
+    void add(Collider* collider);
+    void remove(Collider* collider);
+    // refits the collider after its node or volume moved
+    void update(Collider* collider);
+    void clear();
+
+    size_t size() const;
+
+    // closest hit, target is nullptr when nothing is hit
+    CollisionInfo raycast(const math::Ray& ray) const;
+    // closest hit per ray, result[i] belongs to rays[i]; the traversal stack is shared by the whole batch
+    std::vector<CollisionInfo> raycast(const std::vector<math::Ray>& rays) const;
+    void raycast(const math::Ray* rays, CollisionInfo* results, size_t count) const;
+
+    static Bounds getWorldBounds(const Collider& collider);
+
+private:
+    AABBTree<Collider*> m_tree;
+    std::unordered_map<Collider*, AABBTree<Collider*>::ProxyId> m_proxies;
+};
+
+#include "impl/RaycastTree.inl"
+
+} // namespace w4::core
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#include "W4Math.h"
+#include "BoneIndex.h"
+#include "FatalError.h"
+#include "SimpleSkinnedAnimation.h"
+
+#if !defined(__EMSCRIPTEN__)
+    #include <atomic>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+#endif
+
+namespace w4::resources {
+
+/*
+ * LocalPose - local bone transforms of one skeleton in SoA layout
+ *      - rotations are unit (x, y, z, w) quaternions
+ *      - indexed by bone, the same order as the skeleton (or the animation tracks for a sampled pose)
+ * */
+struct LocalPose
+{
+    std::vector<math::vec3>       translations;
+    std::vector<math::Quaternion> rotations;
+    std::vector<math::vec3>       scales;
+
+    void resize(size_t bonesCount);
+    size_t size() const;
+    void set(size_t bone, const math::Transform& transform);
+};
+
+// local pose of every animation bone at time, in animation bone order
+// generic path: one getTransform() matrix per bone, decomposed
+void samplePose(const SkinnedAnimation& animation, float time, LocalPose& pose);
+// reads the tracks with Track::sample: the accessors keep a cursor, this one can be shared between threads
+void samplePose(const SimpleSkinnedAnimation& animation, float time, LocalPose& pose);
+
+/*
+ * PoseBlender - weighted sum of sampled poses
+ *      - translations and scales are blended linearly, rotations by normalized lerp in the hemisphere
+ *        of the first contribution
+ *      - bones with total weight below 1 are completed with the bind pose
+ * */
+class PoseBlender
+{
+public:
+    using Mapping = std::vector<std::pair<BoneIndex, BoneIndex>>;  // (pose bone, skeleton bone)
+
+    void begin(size_t bonesCount);
+    // boneWeights is optional, indexed by pose bone
+    void add(const LocalPose& pose, const Mapping& mapping, float weight, const float* boneWeights = nullptr);
+    void finish(const LocalPose& bindPose, LocalPose& out) const;
+
+private:
+    void accumulate(BoneIndex bone, const math::vec3& translation, const math::Quaternion& rotation, const math::vec3& scale, float weight);
+
+private:
+    LocalPose m_sum;
+    std::vector<float> m_weights;
+};
+
+/*
+ * SkeletonPose - local pose to world matrices
+ *      - local matrices are built from TRS directly, without intermediate Transform/Rotator objects
+ *      - one linear pass in parent-before-child order produces the world matrices
+ *      - the skin palette (world * inverse bind) is made in one batch if inverse bind matrices are set
+ * */
+class SkeletonPose
+{
+public:
+    static constexpr int32_t NoParent = -1;
+
+    // parents[i] is the parent bone of bone i or NoParent
+    void setHierarchy(const std::vector<int32_t>& parents);
+    void setInverseBindMatrices(std::vector<math::mat4> matrices);
+
+    // bonesLimit: only the first bones in depth order take the pose, the rest keep their last local matrix
+    void evaluate(const LocalPose& pose, const math::mat4& root, size_t bonesLimit = std::numeric_limits<size_t>::max());
+
+    size_t size() const;
+    const std::vector<math::mat4>& getLocalMatrices() const;
+    const std::vector<math::mat4>& getWorldMatrices() const;
+    const std::vector<math::mat4>& getSkinMatrices() const;
+
+    static void composeMatrix(const math::vec3& translation, const math::Quaternion& rotation, const math::vec3& scale, math::mat4& out);
+
+private:
+    std::vector<int32_t>    m_parents;
+    std::vector<uint32_t>   m_order;
+    std::vector<math::mat4> m_locals;
+    std::vector<math::mat4> m_worlds;
+    std::vector<math::mat4> m_inverseBind;
+    std::vector<math::mat4> m_skin;
+    bool m_hasLocals = false;
+};
+
+/*
+ * PoseWorkers - runs independent pose jobs (one per skinned mesh) on a worker pool
+ *      - native builds only, under Emscripten and with 0 threads the jobs run serially on the caller
+ *      - the calling thread takes jobs too and run() returns when all of them are done
+ * */
+class PoseWorkers
+{
+public:
+    using Job = std::function<void(size_t)>;
+
+    static void run(size_t count, const Job& job);
+    static void setThreadsCount(size_t count);
+    static size_t getThreadsCount();
+    static size_t getDefaultThreadsCount();
+
+private:
+#if !defined(__EMSCRIPTEN__)
+    struct Pool
+    {
+        ~Pool();
+        void start(size_t count);
+        void stop();
+        void work(uint64_t seen);
+        void drain();
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const Job* job = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> next{0};
+        size_t pending = 0;
+        uint64_t generation = 0;
+        bool isStopping = false;
+    };
+
+    static Pool& getPool();
+#endif
+};
+
+#include "impl/SkeletonPose.inl"
+
+} // namespace w4::resources
@@ -2,6 +2,12 @@
 
 #include <unordered_map>
 #include <functional>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+#include "FatalError.h"
 
 namespace w4::core {
 
@@ -39,6 +45,81 @@ private:
     std::unordered_map<Handle, Task> m_addedTasks;
 };
 
+/*
+ * TimerWheel - hierarchical timer wheel, advance() only touches the timers expiring in the elapsed ticks
+ *      - Levels wheels of SlotsPerLevel slots, a timer goes to the lowest level its remaining ticks fit in
+ *      - the slots of a higher level are cascaded down when the level below wraps around
+ *      - timers are linked lists of indices in one vector, add and remove are O(1) and allocation free once warm
+ *      - a Handle is the timer index and a generation, a stale handle stays invalid after the slot is reused
+ *      - periods up to MaxTicks ticks (about 49 days at the default 1 ms tick), longer ones are a fatal error
+ *      - Timer::addTask, removeTask and isActiveTask still go through TaskPool and never reach a wheel,
+ *        a TimerWheel is created and advanced by the app itself, e.g. from IGame::onUpdate
+ *      - advance() scans ahead to the next occupied level 0 slot or cascade instead of running a full tick per empty slot
+ * */
+class TimerWheel
+{
+public:
+    // false from a looped callback stops it
+    using Callable = std::function<bool (void)>;
+    using Handle = uint32_t;
+
+    static constexpr Handle InvalidHandle = 0;
+    static constexpr size_t Levels = 4;
+    static constexpr size_t SlotBits = 8;
+    static constexpr size_t SlotsPerLevel = size_t(1) << SlotBits;
+    static constexpr uint64_t MaxTicks = uint64_t(1) << (SlotBits * Levels);
+
+    explicit TimerWheel(float tickDuration = 0.001f);
+
+    Handle add(float period, const Callable& callable, bool isLooped = false);
+    bool remove(Handle handle);
+    bool isActive(Handle handle) const;
+
+    // fires the timers expired in dt, in expiry order; returns how many were fired
+    size_t advance(float dt);
+
+    void reset();
+    bool isEmpty() const;
+    size_t size() const;
+
+private:
+    static constexpr uint32_t Null = ~uint32_t(0);
+    static constexpr uint32_t IndexBits = 20;
+    static constexpr uint32_t IndexMask = (uint32_t(1) << IndexBits) - 1;
+    static constexpr uint32_t MaxGeneration = ~uint32_t(0) >> IndexBits;
+
+    struct Timer
+    {
+        Callable func;
+        uint64_t expiry = 0;
+        uint64_t period = 0;
+        uint32_t prev = Null;
+        uint32_t next = Null;
+        uint32_t slot = Null;
+        uint32_t generation = 1;
+        bool isLooped = false;
+        bool isActive = false;
+    };
+
+    Handle makeHandle(uint32_t index) const;
+    uint32_t findIndex(Handle handle) const;
+    void schedule(uint32_t index);
+    void link(uint32_t index, uint32_t slot);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(size_t level);
+
+private:
+    float m_tickDuration;
+    double m_pendingTicks = 0.0;
+    uint64_t m_tick = 0;
+    uint32_t m_firing = Null;
+    std::vector<Timer> m_timers;
+    std::vector<uint32_t> m_free;
+    std::array<uint32_t, Levels * SlotsPerLevel> m_slots;
+    size_t m_size = 0;
+};
+
 #include "impl/TaskPool.inl"
 
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <vector>
 #include <utility>
 #include <tuple>
+#include <algorithm>
 
 #include "W4Math.h"
 #include "Object.h"
@@ -36,6 +37,36 @@ namespace w4::resources {
         }
     };
 
+    /*
+     * TrackSeekIndex - uniform time buckets over the keys of a track
+     *      - a bucket keeps the first key at or after its start, a lookup scans only the keys of one bucket
+     *      - as many buckets as keys, so evenly spread keys are found in O(1), clustered ones fall back to a binary search in the bucket
+     *      - built once after the keys change, lookups are read only
+     *      - Track does not own one: whoever seeks builds it over Track::getKeyTime() and rebuilds it after the keys change
+     * */
+    class TrackSeekIndex
+    {
+    public:
+        template<typename GetTime>
+        void build(size_t count, GetTime&& getTime);
+        void clear();
+        bool isBuilt() const;
+
+        // index of the first key after time, same as std::upper_bound over the key times
+        template<typename GetTime>
+        size_t upperBound(float time, GetTime&& getTime) const;
+
+        size_t getMemorySize() const;
+
+    private:
+        size_t getBucket(float time) const;
+
+    private:
+        float m_startTime = 0.f;
+        float m_bucketsPerSecond = 0.f;
+        std::vector<uint32_t> m_firstKeys;  // buckets + 1
+    };
+
     template<typename T>
     class Track : public Resource
     {
@@ -106,12 +137,24 @@ namespace w4::resources {
 
         void setValues(Values &&);
 
+        // stateless lookup, safe to call from several threads at once
+        T sample(float time) const;
+
+        float getKeyTime(size_t index) const;
+        const Value& getKey(size_t index) const;
+
+        // bytes taken by the keys
+        size_t getMemorySize() const;
+
     protected:
         Track(const ResourceLoadDescr& descr);
 
     private:
         void removeAccessor(Accessor *accessor);
 
+        const Value& getValueByOffset(size_t index, int offset) const;
+        size_t upperBound(float time) const;
+
         void invalidateAccessors();
 
         std::unordered_set<Accessor *> m_accessors;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+
+namespace w4::core {
+
+/*
+ * TransformChangeQueue - coalesces transform change notifications until flush()
+ *      - push() records a changed node, repeated changes of the node or its subtree cost nothing more
+ *      - flush() delivers exactly one notification per node of every changed subtree, parents first
+ *      - erase() drops the node and every queued node of its subtree, call it when the subtree is removed
+ *      - T has to provide getParent() and getChildren() like core::Node
+ *      - it batches the app's own reactions only, Node setters still notify the engine at once
+ * */
+template<typename T>
+class TransformChangeQueue
+{
+public:
+    void push(T* node);
+    void erase(T* node);
+    void clear();
+
+    bool empty() const;
+    size_t size() const;
+
+    // callback: void(T&); returns the number of delivered notifications
+    template<typename Callback>
+    size_t flush(Callback&& callback);
+
+private:
+    bool hasPendingAncestor(const T* node) const;
+
+private:
+    std::vector<T*> m_pending;
+    std::unordered_set<const T*> m_pendingSet;
+
+    std::vector<T*> m_roots;
+    std::vector<T*> m_stack;
+};
+
+#include "impl/TransformChangeQueue.inl"
+
+} // namespace w4::core
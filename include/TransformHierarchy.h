@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "W4Math.h"
+#include "FatalError.h"
+
+namespace w4::core {
+
+class Node;
+
+/*
+ * TransformHierarchy - local/world transforms of a node tree kept in flat arrays
+ *      - entries are ordered by hierarchy depth, a parent always precedes its children
+ *      - setLocal() only marks the entry dirty, update() recomputes dirty entries and their
+ *        descendants in one linear pass over the arrays
+ *      - slots are stable handles, dense indices change when the order is repaired
+ *      - a mirror of the tree, not its source: Node still propagates its own transforms recursively,
+ *        so whoever edits a node repeats the edit with setLocal() and reads the result back from here
+ * */
+class TransformHierarchy
+{
+public:
+    using Slot = uint32_t;
+    static constexpr Slot Null = std::numeric_limits<Slot>::max();
+
+    Slot add(Node* node, Slot parent, const math::Transform& local);
+    void remove(Slot slot);
+    void setParent(Slot slot, Slot parent);
+    void setLocal(Slot slot, const math::Transform& local);
+    void clear();
+
+    Node* getNode(Slot slot) const;
+    Slot getParent(Slot slot) const;
+    const math::Transform& getLocal(Slot slot) const;
+
+    // up to date even before update(): a stale entry is resolved through its ancestors chain
+    const math::Transform& getWorld(Slot slot);
+    const math::mat4& getWorldMatrix(Slot slot);
+    const math::mat3& getNormalMatrix(Slot slot);
+
+    // returns the number of recomputed entries
+    size_t update();
+    // nodes recomputed by the last update(), in depth order
+    const std::vector<Node*>& getUpdated() const;
+
+    size_t size() const;
+    bool isDirty() const;
+
+private:
+    static constexpr uint32_t Dead = std::numeric_limits<uint32_t>::max();
+
+    void reorder();
+    void resolve(uint32_t& index);
+    void compute(uint32_t index);
+    bool isOrderValid(uint32_t parentIndex, uint32_t index) const;
+
+private:
+    // dense arrays, indexed by position in depth order
+    std::vector<Node*>           m_nodes;
+    std::vector<Slot>            m_slots;
+    std::vector<uint32_t>        m_parents;
+    std::vector<math::Transform> m_locals;
+    std::vector<math::Transform> m_worlds;
+    std::vector<math::mat4>      m_matrices;
+    std::vector<math::mat3>      m_normals;
+    std::vector<uint8_t>         m_dirty;
+
+    // slot -> dense index
+    std::vector<uint32_t> m_indices;
+    std::vector<Slot>     m_freeSlots;
+
+    std::vector<Node*>    m_updated;
+    std::vector<uint32_t> m_chain;
+    size_t m_count = 0;
+    size_t m_dirtyCount = 0;
+    bool m_isOrderDirty = false;
+};
+
+#include "impl/TransformHierarchy.inl"
+
+} // namespace w4::core
@@ -28,6 +28,9 @@ public:
     VertexFormat &operator[](size_t index);
     size_t verticesCount() const;
 
+    // storage for verticesCount vertices to be written in place, the capacity is kept between frames
+    VertexFormat* resize(size_t verticesCount);
+
     void removeVertex(size_t index);
 
     const void* data() const override;
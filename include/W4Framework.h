@@ -63,6 +63,7 @@
     #include "Nodes/SkinnedMesh.h"
     #include "Nodes/Billboard.h"
     #include "Nodes/ParticlesEmitter.h"
+    #include "ParticlesManager.h"
     #include "Nodes/ArcBallNode.h"
     #include "Nodes/Camera.h"
     #include "Nodes/PointLight.h"
@@ -94,6 +95,8 @@
     #include "Track.h"
     #include "Tween.h"
     #include "Asset.h"
+    #include "AssetLoader.h"
+    #include "PackageReader.h"
     #include "Binary.h"
 
 #define W4_USE_UNSTRICT_INTERFACE       \
@@ -11,6 +11,7 @@
 
 #include "W4Common.h"
 #include "impl/W4MathIvec.h"
+#include "impl/W4MathSimd.h"
 
 namespace w4::math {
 
@@ -668,6 +669,23 @@ T cubic(const T &a, const T &b, const T &c, const T &d, float t);
 
 Rotator lerp(const Rotator& a, const Rotator& b, float t);
 
+// opt-in single item kernels of impl/W4MathSimd.h: operator*(mat4, mat4), mat4::invert, Transform::getMatrix
+// and Quaternion::operator* are compiled in the engine library and stay scalar
+mat4 multiply(mat4::cref lhs, mat4::cref rhs);
+// Hamilton product lhs * rhs
+Quaternion multiply(Quaternion::cref lhs, Quaternion::cref rhs);
+
+// batch API on top of impl/W4MathSimd.h, out may alias the input
+void transformPoints(mat4::cref m, const vec3* points, vec3* out, size_t count);
+void transformDirections(mat4::cref m, const vec3* directions, vec3* out, size_t count);
+void transformVectors(mat4::cref m, const vec4* vectors, vec4* out, size_t count);
+// out[i] = parent * matrices[i]
+void multiply(mat4::cref parent, const mat4* matrices, mat4* out, size_t count);
+// out[i] = lhs[i] * rhs[i]
+void multiply(const mat4* lhs, const mat4* rhs, mat4* out, size_t count);
+// out[i] = parent.getMatrix() * locals[i].getMatrix(), the matrix of parent + locals[i] for uniformly scaled parents
+void compose(Transform::cref parent, const Transform* locals, mat4* out, size_t count);
+
 mat4 makeOrthoProjectionMatrix(float left, float right, float bottom, float top, float near, float far);
 mat4 makePerspectiveProjectionMatrix(float fov, float aspect, float near, float far);
 mat4 lookAt(vec3 const& eye, vec3 const& center, vec3 const& up);
@@ -0,0 +1,601 @@
+template<typename T>
+AABBTree<T>::AABBTree(float margin)
+    : m_margin(margin)
+{
+}
+
+template<typename T>
+typename AABBTree<T>::ProxyId AABBTree<T>::insert(const Bounds& bounds, T data)
+{
+    auto id = allocateNode();
+    auto& node = m_nodes[id];
+    node.bounds.min() = math::vec3(bounds.min().x - m_margin, bounds.min().y - m_margin, bounds.min().z - m_margin);
+    node.bounds.max() = math::vec3(bounds.max().x + m_margin, bounds.max().y + m_margin, bounds.max().z + m_margin);
+    node.data = data;
+    node.height = 0;
+    insertLeaf(id);
+    ++m_leavesCount;
+    return id;
+}
+
+template<typename T>
+void AABBTree<T>::remove(ProxyId id)
+{
+    W4_ASSERT(id >= 0 && id < static_cast<ProxyId>(m_nodes.size()) && m_nodes[id].isLeaf());
+    removeLeaf(id);
+    freeNode(id);
+    --m_leavesCount;
+}
+
+template<typename T>
+bool AABBTree<T>::move(ProxyId id, const Bounds& bounds)
+{
+    W4_ASSERT(id >= 0 && id < static_cast<ProxyId>(m_nodes.size()) && m_nodes[id].isLeaf());
+    if (contains(m_nodes[id].bounds, bounds))
+    {
+        return false;
+    }
+    removeLeaf(id);
+    auto& node = m_nodes[id];
+    node.bounds.min() = math::vec3(bounds.min().x - m_margin, bounds.min().y - m_margin, bounds.min().z - m_margin);
+    node.bounds.max() = math::vec3(bounds.max().x + m_margin, bounds.max().y + m_margin, bounds.max().z + m_margin);
+    insertLeaf(id);
+    return true;
+}
+
+template<typename T>
+void AABBTree<T>::rebuild()
+{
+    std::vector<ProxyId> leaves;
+    leaves.reserve(m_leavesCount);
+    for (ProxyId i = 0; i < static_cast<ProxyId>(m_nodes.size()); ++i)
+    {
+        auto& node = m_nodes[i];
+        if (node.height < 0)
+        {
+            continue;
+        }
+        if (node.isLeaf())
+        {
+            leaves.push_back(i);
+        }
+        else
+        {
+            freeNode(i);
+        }
+    }
+    m_root = leaves.empty() ? Null : buildTopDown(leaves.data(), leaves.size());
+    if (m_root != Null)
+    {
+        m_nodes[m_root].parent = Null;
+    }
+}
+
+template<typename T>
+void AABBTree<T>::clear()
+{
+    m_nodes.clear();
+    m_root = Null;
+    m_freeList = Null;
+    m_leavesCount = 0;
+}
+
+template<typename T>
+T AABBTree<T>::getData(ProxyId id) const
+{
+    return m_nodes[id].data;
+}
+
+template<typename T>
+const Bounds& AABBTree<T>::getFatBounds(ProxyId id) const
+{
+    return m_nodes[id].bounds;
+}
+
+template<typename T>
+size_t AABBTree<T>::size() const
+{
+    return m_leavesCount;
+}
+
+template<typename T>
+int32_t AABBTree<T>::getHeight() const
+{
+    return m_root == Null ? 0 : m_nodes[m_root].height;
+}
+
+template<typename T>
+template<typename Callback>
+void AABBTree<T>::query(const Bounds& bounds, Callback&& callback) const
+{
+    if (m_root == Null)
+    {
+        return;
+    }
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty())
+    {
+        auto id = m_stack.back();
+        m_stack.pop_back();
+        const auto& node = m_nodes[id];
+        if (!overlaps(node.bounds, bounds))
+        {
+            continue;
+        }
+        if (node.isLeaf())
+        {
+            if (!callback(id, node.data))
+            {
+                return;
+            }
+        }
+        else
+        {
+            m_stack.push_back(node.child1);
+            m_stack.push_back(node.child2);
+        }
+    }
+}
+
+template<typename T>
+template<typename Callback>
+typename AABBTree<T>::Stats AABBTree<T>::queryFrustum(const math::Frustum& frustum, Callback&& callback) const
+{
+    Stats stats;
+    if (m_root == Null)
+    {
+        return stats;
+    }
+    m_stack.clear();
+    m_stack.push_back(m_root);
+    while (!m_stack.empty())
+    {
+        auto id = m_stack.back();
+        m_stack.pop_back();
+        const auto& node = m_nodes[id];
+        ++stats.tested;
+        switch (classify(node.bounds, frustum))
+        {
+            case Classification::Outside:
+                break;
+            case Classification::Inside:
+                acceptSubtree(id, stats, callback);
+                break;
+            case Classification::Intersect:
+                if (node.isLeaf())
+                {
+                    ++stats.accepted;
+                    callback(node.data, false);
+                }
+                else
+                {
+                    m_stack.push_back(node.child1);
+                    m_stack.push_back(node.child2);
+                }
+                break;
+        }
+    }
+    stats.culled = static_cast<uint32_t>(m_leavesCount) - stats.accepted;
+    return stats;
+}
+
+template<typename T>
+template<typename Callback>
+void AABBTree<T>::acceptSubtree(ProxyId id, Stats& stats, Callback& callback) const
+{
+    const auto& node = m_nodes[id];
+    if (node.isLeaf())
+    {
+        ++stats.accepted;
+        callback(node.data, true);
+        return;
+    }
+    acceptSubtree(node.child1, stats, callback);
+    acceptSubtree(node.child2, stats, callback);
+}
+
+template<typename T>
+template<typename Callback>
+void AABBTree<T>::raycast(const math::Ray& ray, float maxDistance, Callback&& callback) const
+{
+    if (m_root == Null)
+    {
+        return;
+    }
+
+    auto inverse = [](float v)
+    {
+        return std::abs(v) > std::numeric_limits<float>::min() ? 1.f / v : std::copysign(std::numeric_limits<float>::infinity(), v);
+    };
+    const math::vec3 invDirection(inverse(ray.direction.x), inverse(ray.direction.y), inverse(ray.direction.z));
+
+    float entry;
+    if (!intersectRay(m_nodes[m_root].bounds, ray.origin, invDirection, maxDistance, entry))
+    {
+        return;
+    }
+    m_rayStack.clear();
+    m_rayStack.emplace_back(m_root, entry);
+    while (!m_rayStack.empty())
+    {
+        auto [id, nodeEntry] = m_rayStack.back();
+        m_rayStack.pop_back();
+        // the closest hit may have been found after this node was pushed
+        if (nodeEntry > maxDistance)
+        {
+            continue;
+        }
+
+        const auto& node = m_nodes[id];
+        if (node.isLeaf())
+        {
+            maxDistance = callback(id, node.data, nodeEntry);
+            continue;
+        }
+
+        float entry1, entry2;
+        const bool hit1 = intersectRay(m_nodes[node.child1].bounds, ray.origin, invDirection, maxDistance, entry1);
+        const bool hit2 = intersectRay(m_nodes[node.child2].bounds, ray.origin, invDirection, maxDistance, entry2);
+        // push the far child first so the near one is visited first
+        if (hit1 && hit2)
+        {
+            if (entry1 <= entry2)
+            {
+                m_rayStack.emplace_back(node.child2, entry2);
+                m_rayStack.emplace_back(node.child1, entry1);
+            }
+            else
+            {
+                m_rayStack.emplace_back(node.child1, entry1);
+                m_rayStack.emplace_back(node.child2, entry2);
+            }
+        }
+        else if (hit1)
+        {
+            m_rayStack.emplace_back(node.child1, entry1);
+        }
+        else if (hit2)
+        {
+            m_rayStack.emplace_back(node.child2, entry2);
+        }
+    }
+}
+
+template<typename T>
+bool AABBTree<T>::intersectRay(const Bounds& bounds, const math::vec3& origin, const math::vec3& invDirection, float maxDistance, float& entry)
+{
+    float tMin = 0.f;
+    float tMax = maxDistance;
+    for (unsigned axis = 0; axis < 3; ++axis)
+    {
+        float t1 = (bounds.min()[axis] - origin[axis]) * invDirection[axis];
+        float t2 = (bounds.max()[axis] - origin[axis]) * invDirection[axis];
+        // 0 * inf gives nan for rays lying on a slab plane, treat them as inside the slab
+        if (std::isnan(t1) || std::isnan(t2))
+        {
+            continue;
+        }
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax)
+        {
+            return false;
+        }
+    }
+    entry = tMin;
+    return true;
+}
+
+template<typename T>
+bool AABBTree<T>::overlaps(const Bounds& lh, const Bounds& rh)
+{
+    return lh.min().x <= rh.max().x && lh.max().x >= rh.min().x
+        && lh.min().y <= rh.max().y && lh.max().y >= rh.min().y
+        && lh.min().z <= rh.max().z && lh.max().z >= rh.min().z;
+}
+
+template<typename T>
+bool AABBTree<T>::contains(const Bounds& outer, const Bounds& inner)
+{
+    return outer.min().x <= inner.min().x && outer.max().x >= inner.max().x
+        && outer.min().y <= inner.min().y && outer.max().y >= inner.max().y
+        && outer.min().z <= inner.min().z && outer.max().z >= inner.max().z;
+}
+
+template<typename T>
+Bounds AABBTree<T>::merge(const Bounds& lh, const Bounds& rh)
+{
+    Bounds result;
+    result.min() = math::vec3(std::min(lh.min().x, rh.min().x), std::min(lh.min().y, rh.min().y), std::min(lh.min().z, rh.min().z));
+    result.max() = math::vec3(std::max(lh.max().x, rh.max().x), std::max(lh.max().y, rh.max().y), std::max(lh.max().z, rh.max().z));
+    return result;
+}
+
+template<typename T>
+float AABBTree<T>::area(const Bounds& bounds)
+{
+    const float dx = bounds.max().x - bounds.min().x;
+    const float dy = bounds.max().y - bounds.min().y;
+    const float dz = bounds.max().z - bounds.min().z;
+    return 2.f * (dx * dy + dy * dz + dz * dx);
+}
+
+template<typename T>
+typename AABBTree<T>::ProxyId AABBTree<T>::allocateNode()
+{
+    if (m_freeList == Null)
+    {
+        m_nodes.emplace_back();
+        m_freeList = static_cast<ProxyId>(m_nodes.size()) - 1;
+        m_nodes.back().next = Null;
+    }
+    auto id = m_freeList;
+    auto& node = m_nodes[id];
+    m_freeList = node.next;
+    node.parent = Null;
+    node.child1 = Null;
+    node.child2 = Null;
+    node.height = 0;
+    return id;
+}
+
+template<typename T>
+void AABBTree<T>::freeNode(ProxyId id)
+{
+    auto& node = m_nodes[id];
+    node.data = T{};
+    node.height = -1;
+    node.child1 = Null;
+    node.child2 = Null;
+    node.next = m_freeList;
+    m_freeList = id;
+}
+
+template<typename T>
+void AABBTree<T>::insertLeaf(ProxyId leaf)
+{
+    if (m_root == Null)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = Null;
+        return;
+    }
+
+    // descend to the cheapest sibling
+    const auto leafBounds = m_nodes[leaf].bounds;
+    auto index = m_root;
+    while (!m_nodes[index].isLeaf())
+    {
+        const auto& node = m_nodes[index];
+        const float nodeArea = area(node.bounds);
+        const float combinedArea = area(merge(node.bounds, leafBounds));
+
+        const float cost = 2.f * combinedArea;
+        const float inheritanceCost = 2.f * (combinedArea - nodeArea);
+
+        auto childCost = [&](ProxyId child)
+        {
+            const auto& childNode = m_nodes[child];
+            const float merged = area(merge(childNode.bounds, leafBounds));
+            return childNode.isLeaf() ? merged + inheritanceCost : merged - area(childNode.bounds) + inheritanceCost;
+        };
+        const float cost1 = childCost(node.child1);
+        const float cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const auto sibling = index;
+    const auto oldParent = m_nodes[sibling].parent;
+    const auto newParent = allocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].bounds = merge(leafBounds, m_nodes[sibling].bounds);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent == Null)
+    {
+        m_root = newParent;
+    }
+    else if (m_nodes[oldParent].child1 == sibling)
+    {
+        m_nodes[oldParent].child1 = newParent;
+    }
+    else
+    {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    refitAncestors(m_nodes[leaf].parent);
+}
+
+template<typename T>
+void AABBTree<T>::removeLeaf(ProxyId leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = Null;
+        return;
+    }
+
+    const auto parent = m_nodes[leaf].parent;
+    const auto grandParent = m_nodes[parent].parent;
+    const auto sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent == Null)
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = Null;
+        freeNode(parent);
+        return;
+    }
+
+    if (m_nodes[grandParent].child1 == parent)
+    {
+        m_nodes[grandParent].child1 = sibling;
+    }
+    else
+    {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    m_nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    refitAncestors(grandParent);
+}
+
+template<typename T>
+void AABBTree<T>::refitAncestors(ProxyId id)
+{
+    while (id != Null)
+    {
+        id = balance(id);
+        auto& node = m_nodes[id];
+        node.bounds = merge(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        id = node.parent;
+    }
+}
+
+// rotates the taller grandchild up if the subtree rooted at id is unbalanced, returns the new subtree root
+template<typename T>
+typename AABBTree<T>::ProxyId AABBTree<T>::balance(ProxyId a)
+{
+    auto& nodeA = m_nodes[a];
+    if (nodeA.isLeaf() || nodeA.height < 2)
+    {
+        return a;
+    }
+
+    const auto b = nodeA.child1;
+    const auto c = nodeA.child2;
+    const int32_t diff = m_nodes[c].height - m_nodes[b].height;
+    if (diff >= -1 && diff <= 1)
+    {
+        return a;
+    }
+
+    // up is the taller child, side is the shorter one
+    const auto up = diff > 0 ? c : b;
+    const auto side = diff > 0 ? b : c;
+    auto& nodeUp = m_nodes[up];
+    const auto f = nodeUp.child1;
+    const auto g = nodeUp.child2;
+
+    nodeUp.child1 = a;
+    nodeUp.parent = nodeA.parent;
+    nodeA.parent = up;
+
+    if (nodeUp.parent == Null)
+    {
+        m_root = up;
+    }
+    else if (m_nodes[nodeUp.parent].child1 == a)
+    {
+        m_nodes[nodeUp.parent].child1 = up;
+    }
+    else
+    {
+        m_nodes[nodeUp.parent].child2 = up;
+    }
+
+    // keep the taller grandchild under up, move the shorter one under a
+    const bool keepF = m_nodes[f].height > m_nodes[g].height;
+    const auto keep = keepF ? f : g;
+    const auto moved = keepF ? g : f;
+
+    nodeUp.child2 = keep;
+    if (diff > 0)
+    {
+        nodeA.child2 = moved;
+    }
+    else
+    {
+        nodeA.child1 = moved;
+    }
+    m_nodes[moved].parent = a;
+
+    nodeA.bounds = merge(m_nodes[side].bounds, m_nodes[moved].bounds);
+    nodeA.height = 1 + std::max(m_nodes[side].height, m_nodes[moved].height);
+    nodeUp.bounds = merge(nodeA.bounds, m_nodes[keep].bounds);
+    nodeUp.height = 1 + std::max(nodeA.height, m_nodes[keep].height);
+
+    return up;
+}
+
+template<typename T>
+typename AABBTree<T>::ProxyId AABBTree<T>::buildTopDown(ProxyId* leaves, size_t count)
+{
+    if (count == 1)
+    {
+        return leaves[0];
+    }
+
+    auto bounds = m_nodes[leaves[0]].bounds;
+    for (size_t i = 1; i < count; ++i)
+    {
+        bounds = merge(bounds, m_nodes[leaves[i]].bounds);
+    }
+
+    // split along the longest axis at the median of leaf centers
+    const float dx = bounds.max().x - bounds.min().x;
+    const float dy = bounds.max().y - bounds.min().y;
+    const float dz = bounds.max().z - bounds.min().z;
+    const unsigned axis = (dx >= dy && dx >= dz) ? 0 : (dy >= dz ? 1 : 2);
+    const size_t half = count / 2;
+    std::nth_element(leaves, leaves + half, leaves + count, [this, axis](ProxyId lh, ProxyId rh)
+    {
+        const auto& l = m_nodes[lh].bounds;
+        const auto& r = m_nodes[rh].bounds;
+        return l.min()[axis] + l.max()[axis] < r.min()[axis] + r.max()[axis];
+    });
+
+    const auto child1 = buildTopDown(leaves, half);
+    const auto child2 = buildTopDown(leaves + half, count - half);
+    const auto id = allocateNode();
+    auto& node = m_nodes[id];
+    node.child1 = child1;
+    node.child2 = child2;
+    node.bounds = merge(m_nodes[child1].bounds, m_nodes[child2].bounds);
+    node.height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+    m_nodes[child1].parent = id;
+    m_nodes[child2].parent = id;
+    return id;
+}
+
+// planes are normalized with normals pointing inside: dot(n, p) + w >= 0 for points inside
+template<typename T>
+typename AABBTree<T>::Classification AABBTree<T>::classify(const Bounds& bounds, const math::Frustum& frustum)
+{
+    auto result = Classification::Inside;
+    for (const auto& plane: frustum.planes)
+    {
+        const float px = plane.x >= 0.f ? bounds.max().x : bounds.min().x;
+        const float py = plane.y >= 0.f ? bounds.max().y : bounds.min().y;
+        const float pz = plane.z >= 0.f ? bounds.max().z : bounds.min().z;
+        if (plane.x * px + plane.y * py + plane.z * pz + plane.w < 0.f)
+        {
+            return Classification::Outside;
+        }
+        const float nx = plane.x >= 0.f ? bounds.min().x : bounds.max().x;
+        const float ny = plane.y >= 0.f ? bounds.min().y : bounds.max().y;
+        const float nz = plane.z >= 0.f ? bounds.min().z : bounds.max().z;
+        if (plane.x * nx + plane.y * ny + plane.z * nz + plane.w < 0.f)
+        {
+            result = Classification::Intersect;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,179 @@
+inline AnimationLod::Counters AnimationLod::m_frameCounters;
+inline AnimationLod::Counters AnimationLod::m_lastFrameCounters;
+
+inline AnimationLod::AnimationLod()
+    : m_levels(1)
+{
+}
+
+inline AnimationLod::AnimationLod(std::vector<Level> levels)
+{
+    setLevels(std::move(levels));
+}
+
+inline void AnimationLod::setLevels(std::vector<Level> levels)
+{
+    W4_ASSERT(!levels.empty());
+    m_levels = std::move(levels);
+    m_lastEvaluatedFrame = std::numeric_limits<uint64_t>::max();
+}
+
+inline const std::vector<AnimationLod::Level>& AnimationLod::getLevels() const
+{
+    return m_levels;
+}
+
+inline void AnimationLod::setPhase(uint32_t phase)
+{
+    m_phase = phase;
+}
+
+inline size_t AnimationLod::selectLevel(float distance, float screenSize) const
+{
+    size_t result = 0;
+    for (size_t i = 1; i < m_levels.size(); ++i)
+    {
+        const auto& level = m_levels[i];
+        if (distance >= level.distance || screenSize <= level.screenSize)
+        {
+            result = i;
+        }
+    }
+    return result;
+}
+
+inline AnimationLod::Decision AnimationLod::update(float distance, float screenSize, bool isVisible, uint64_t frame)
+{
+    Decision decision;
+    if (!isVisible)
+    {
+        // evaluated right away when it shows up again
+        m_lastEvaluatedFrame = std::numeric_limits<uint64_t>::max();
+        decision.action = Action::Skip;
+        ++m_frameCounters.skipped;
+        return decision;
+    }
+
+    decision.level = selectLevel(distance, screenSize);
+    const auto& level = m_levels[decision.level];
+    decision.maxBones = level.maxBones;
+    const auto interval = std::max<uint32_t>(level.interval, 1);
+
+    const auto isFirst = m_lastEvaluatedFrame == std::numeric_limits<uint64_t>::max();
+    const auto sinceLast = isFirst ? 0 : frame - m_lastEvaluatedFrame;
+    const auto isDue = interval == 1 || isFirst || (frame + m_phase) % interval == 0 || sinceLast >= m_lastInterval;
+    if (isDue)
+    {
+        // the next due frame is the interpolation target
+        const auto ahead = interval == 1 ? 0 : interval - (frame + m_phase) % interval;
+        decision.action = Action::Evaluate;
+        decision.lookAhead = isFirst ? 0.f : static_cast<float>(ahead);
+        decision.alpha = decision.lookAhead > 0.f ? 0.f : 1.f;
+        m_lastEvaluatedFrame = frame;
+        m_lastInterval = isFirst ? ahead : std::max<uint32_t>(ahead, 1);
+        ++m_frameCounters.evaluated;
+        return decision;
+    }
+
+    decision.action = Action::Interpolate;
+    decision.alpha = m_lastInterval == 0 ? 1.f : std::min(static_cast<float>(sinceLast) / m_lastInterval, 1.f);
+    ++m_frameCounters.interpolated;
+    return decision;
+}
+
+inline float AnimationLod::getScreenSize(float radius, float distance, float fovY)
+{
+    if (distance <= radius)
+    {
+        return 1.f;
+    }
+    return std::min(radius / (distance * std::tan(fovY * 0.5f)), 1.f);
+}
+
+inline void AnimationLod::beginFrame()
+{
+    m_lastFrameCounters = m_frameCounters;
+    m_frameCounters = Counters();
+}
+
+inline void AnimationLod::addEvaluatedBones(uint32_t count)
+{
+    m_frameCounters.bonesEvaluated += count;
+}
+
+inline const AnimationLod::Counters& AnimationLod::getFrameCounters()
+{
+    return m_frameCounters;
+}
+
+inline const AnimationLod::Counters& AnimationLod::getLastFrameCounters()
+{
+    return m_lastFrameCounters;
+}
+
+inline void PoseInterpolator::push(const resources::LocalPose& pose)
+{
+    if (m_hasTo)
+    {
+        std::swap(m_from, m_to);
+        m_hasFrom = true;
+    }
+    m_to = pose;
+    m_hasTo = true;
+    if (!m_hasFrom)
+    {
+        m_from = pose;
+        m_hasFrom = true;
+    }
+}
+
+inline const resources::LocalPose& PoseInterpolator::at(float alpha)
+{
+    W4_ASSERT(m_hasTo);
+    if (alpha <= 0.f)
+    {
+        return m_from;
+    }
+    if (alpha >= 1.f || m_from.size() != m_to.size())
+    {
+        return m_to;
+    }
+
+    const auto count = m_to.size();
+    m_result.resize(count);
+    const auto beta = 1.f - alpha;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& t0 = m_from.translations[i];
+        const auto& t1 = m_to.translations[i];
+        m_result.translations[i] = {t0.x * beta + t1.x * alpha, t0.y * beta + t1.y * alpha, t0.z * beta + t1.z * alpha};
+
+        const auto& s0 = m_from.scales[i];
+        const auto& s1 = m_to.scales[i];
+        m_result.scales[i] = {s0.x * beta + s1.x * alpha, s0.y * beta + s1.y * alpha, s0.z * beta + s1.z * alpha};
+
+        // nlerp in the shorter arc
+        const auto& q0 = m_from.rotations[i];
+        const auto& q1 = m_to.rotations[i];
+        const auto b = (q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w) < 0.f ? -alpha : alpha;
+        const auto x = q0.x * beta + q1.x * b;
+        const auto y = q0.y * beta + q1.y * b;
+        const auto z = q0.z * beta + q1.z * b;
+        const auto w = q0.w * beta + q1.w * b;
+        const auto length = std::sqrt(x * x + y * y + z * z + w * w);
+        const auto inv = length > math::EPSILON ? 1.f / length : 0.f;
+        m_result.rotations[i].set(x * inv, y * inv, z * inv, w * inv);
+    }
+    return m_result;
+}
+
+inline void PoseInterpolator::reset()
+{
+    m_hasFrom = false;
+    m_hasTo = false;
+}
+
+inline bool PoseInterpolator::isEmpty() const
+{
+    return !m_hasTo;
+}
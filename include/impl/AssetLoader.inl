@@ -0,0 +1,205 @@
+inline float AssetLoadTask::Progress::getFraction() const
+{
+    return stepsTotal ? static_cast<float>(stepsDone) / stepsTotal : 0.f;
+}
+
+inline AssetLoadTask::AssetLoadTask(const std::string& path, const CompleteCallback& onComplete, const ProgressCallback& onProgress)
+    : m_path(path)
+    , m_onComplete(onComplete)
+    , m_onProgress(onProgress)
+{
+    // the load step
+    m_progress.stepsTotal = 1;
+}
+
+inline const std::string& AssetLoadTask::getPath() const
+{
+    return m_path;
+}
+
+inline AssetLoadTask::State AssetLoadTask::getState() const
+{
+    return m_state;
+}
+
+inline const AssetLoadTask::Progress& AssetLoadTask::getProgress() const
+{
+    return m_progress;
+}
+
+inline bool AssetLoadTask::isFinished() const
+{
+    return m_state == State::Completed || m_state == State::Failed || m_state == State::Cancelled;
+}
+
+inline const sptr<Asset>& AssetLoadTask::getAsset() const
+{
+    return m_asset;
+}
+
+inline void AssetLoadTask::addStep(const Step& step)
+{
+    if (isFinished())
+    {
+        W4_LOG_WARNING("asset '%s': step added to a finished task is ignored", m_path.c_str());
+        return;
+    }
+    m_steps.push_back(step);
+    ++m_progress.stepsTotal;
+}
+
+inline void AssetLoadTask::cancel()
+{
+    m_isCancelRequested = true;
+}
+
+inline bool AssetLoadTask::run(std::chrono::steady_clock::time_point deadline, bool force)
+{
+    if (isFinished())
+    {
+        return true;
+    }
+    m_state = State::Processing;
+
+    const auto stepsBefore = m_progress.stepsDone;
+    auto result = State::Processing;
+    while (force || std::chrono::steady_clock::now() < deadline)
+    {
+        force = false;
+        if (m_isCancelRequested)
+        {
+            result = State::Cancelled;
+            break;
+        }
+
+        bool isDone;
+        if (!m_asset)
+        {
+            isDone = load();
+        }
+        else
+        {
+            auto step = std::move(m_steps.front());
+            m_steps.pop_front();
+            isDone = step();
+            if (!isDone)
+            {
+                W4_LOG_ERROR("asset '%s': step %u failed", m_path.c_str(), m_progress.stepsDone);
+            }
+        }
+        if (!isDone)
+        {
+            result = State::Failed;
+            break;
+        }
+        ++m_progress.stepsDone;
+        if (m_steps.empty())
+        {
+            result = State::Completed;
+            break;
+        }
+    }
+
+    if (m_onProgress && m_progress.stepsDone != stepsBefore)
+    {
+        m_onProgress(m_progress);
+    }
+    if (result != State::Processing)
+    {
+        finish(result);
+    }
+    return isFinished();
+}
+
+inline bool AssetLoadTask::load()
+{
+    m_asset = Asset::contains(m_path) ? Asset::get(m_path) : Asset::load(m_path);
+    if (!m_asset || m_asset->isEmpty())
+    {
+        W4_LOG_ERROR("asset '%s' failed to load", m_path.c_str());
+        m_asset = nullptr;
+        return false;
+    }
+    return true;
+}
+
+inline void AssetLoadTask::finish(State state)
+{
+    m_state = state;
+    m_steps.clear();
+    if (state == State::Completed)
+    {
+        if (!Asset::contains(m_path))
+        {
+            Asset::add(m_path, m_asset);
+        }
+    }
+    else
+    {
+        m_asset = nullptr;
+    }
+
+    auto onComplete = std::move(m_onComplete);
+    m_onComplete = nullptr;
+    m_onProgress = nullptr;
+    if (onComplete)
+    {
+        onComplete(m_asset, state);
+    }
+}
+
+inline sptr<AssetLoadTask> AssetLoader::load(const std::string& path,
+                                              const AssetLoadTask::CompleteCallback& onComplete,
+                                              const AssetLoadTask::ProgressCallback& onProgress)
+{
+    auto task = make::sptr<AssetLoadTask>(path, onComplete, onProgress);
+    m_tasks.push_back(task);
+    return task;
+}
+
+inline void AssetLoader::update()
+{
+    if (m_tasks.empty())
+    {
+        return;
+    }
+    const auto deadline = std::chrono::steady_clock::now()
+                        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::milli>(m_frameBudget));
+
+    // callbacks may submit new tasks, iterate over a snapshot;
+    // the first task always makes a step, the others only within the budget, cancelled ones finish either way
+    auto tasks = m_tasks;
+    bool force = true;
+    for (auto& task: tasks)
+    {
+        task->run(deadline, force);
+        force = false;
+    }
+    m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(), [](const sptr<AssetLoadTask>& task)
+    {
+        return task->isFinished();
+    }), m_tasks.end());
+}
+
+inline void AssetLoader::cancelAll()
+{
+    for (auto& task: m_tasks)
+    {
+        task->cancel();
+    }
+}
+
+inline void AssetLoader::setFrameBudget(float milliseconds)
+{
+    m_frameBudget = std::max(milliseconds, 0.f);
+}
+
+inline float AssetLoader::getFrameBudget()
+{
+    return m_frameBudget;
+}
+
+inline size_t AssetLoader::getPendingCount()
+{
+    return m_tasks.size();
+}
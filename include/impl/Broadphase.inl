@@ -0,0 +1,337 @@
+template<typename T>
+typename SweepAndPrune<T>::ProxyId SweepAndPrune<T>::add(T data, const Bounds& bounds, uint8_t groups)
+{
+    ProxyId id;
+    if (m_free.empty())
+    {
+        id = static_cast<ProxyId>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+    else
+    {
+        id = m_free.back();
+        m_free.pop_back();
+    }
+    auto& proxy = m_proxies[id];
+    proxy.bounds = bounds;
+    proxy.data = data;
+    proxy.groups = groups;
+    proxy.isAlive = true;
+    m_order.push_back(id);
+    ++m_count;
+    return id;
+}
+
+template<typename T>
+void SweepAndPrune<T>::remove(ProxyId id)
+{
+    W4_ASSERT(id < m_proxies.size() && m_proxies[id].isAlive);
+    m_proxies[id].isAlive = false;
+    m_proxies[id].data = T{};
+    m_hasRemoved = true;
+    --m_count;
+}
+
+template<typename T>
+void SweepAndPrune<T>::update(ProxyId id, const Bounds& bounds)
+{
+    m_proxies[id].bounds = bounds;
+}
+
+template<typename T>
+void SweepAndPrune<T>::setGroups(ProxyId id, uint8_t groups)
+{
+    m_proxies[id].groups = groups;
+}
+
+template<typename T>
+uint8_t SweepAndPrune<T>::getGroups(ProxyId id) const
+{
+    return m_proxies[id].groups;
+}
+
+template<typename T>
+void SweepAndPrune<T>::clear()
+{
+    m_proxies.clear();
+    m_free.clear();
+    m_order.clear();
+    m_sweep.clear();
+    m_count = 0;
+    m_hasRemoved = false;
+}
+
+template<typename T>
+size_t SweepAndPrune<T>::size() const
+{
+    return m_count;
+}
+
+template<typename T>
+template<typename Callback>
+void SweepAndPrune<T>::findPairs(uint8_t sourceGroups, uint8_t targetGroups, Callback&& callback)
+{
+    sortAxis();
+
+    m_sweep.clear();
+    for (auto id: m_order)
+    {
+        const auto& proxy = m_proxies[id];
+        const auto& bounds = proxy.bounds;
+
+        // drop proxies that end before this one starts
+        for (size_t i = 0; i < m_sweep.size();)
+        {
+            if (m_proxies[m_sweep[i]].bounds.max().x < bounds.min().x)
+            {
+                m_sweep[i] = m_sweep.back();
+                m_sweep.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        for (auto otherId: m_sweep)
+        {
+            const auto& other = m_proxies[otherId];
+            const auto& otherBounds = other.bounds;
+            if (bounds.min().y > otherBounds.max().y || bounds.max().y < otherBounds.min().y
+             || bounds.min().z > otherBounds.max().z || bounds.max().z < otherBounds.min().z)
+            {
+                continue;
+            }
+            if ((proxy.groups & sourceGroups) && (other.groups & targetGroups))
+            {
+                callback(proxy.data, other.data);
+            }
+            if ((other.groups & sourceGroups) && (proxy.groups & targetGroups))
+            {
+                callback(other.data, proxy.data);
+            }
+        }
+
+        if (proxy.groups & (sourceGroups | targetGroups))
+        {
+            m_sweep.push_back(id);
+        }
+    }
+}
+
+template<typename T>
+void SweepAndPrune<T>::sortAxis()
+{
+    if (m_hasRemoved)
+    {
+        size_t kept = 0;
+        for (auto id: m_order)
+        {
+            if (m_proxies[id].isAlive)
+            {
+                m_order[kept++] = id;
+            }
+            else
+            {
+                m_free.push_back(id);
+            }
+        }
+        m_order.resize(kept);
+        m_hasRemoved = false;
+    }
+
+    for (size_t i = 1; i < m_order.size(); ++i)
+    {
+        const auto id = m_order[i];
+        const float key = m_proxies[id].bounds.min().x;
+        size_t j = i;
+        while (j > 0 && m_proxies[m_order[j - 1]].bounds.min().x > key)
+        {
+            m_order[j] = m_order[j - 1];
+            --j;
+        }
+        m_order[j] = id;
+    }
+}
+
+template<typename T, typename V>
+V& PairTable<T, V>::operator()(T first, T second)
+{
+    auto index = findIndex(first, second);
+    if (index >= 0)
+    {
+        return m_entries[index].value;
+    }
+
+    // keep the index at most half full
+    if ((m_entries.size() + 1) * 2 > m_index.size())
+    {
+        rebuildIndex(std::max<size_t>(16, m_index.size() * 2));
+    }
+    m_entries.push_back({first, second, V{}});
+
+    const size_t mask = m_index.size() - 1;
+    for (size_t slot = hash(first, second) & mask;; slot = (slot + 1) & mask)
+    {
+        if (m_index[slot] < 0)
+        {
+            m_index[slot] = static_cast<int32_t>(m_entries.size()) - 1;
+            break;
+        }
+    }
+    return m_entries.back().value;
+}
+
+template<typename T, typename V>
+V* PairTable<T, V>::find(T first, T second)
+{
+    auto index = findIndex(first, second);
+    return index >= 0 ? &m_entries[index].value : nullptr;
+}
+
+template<typename T, typename V>
+void PairTable<T, V>::erase(T first, T second)
+{
+    const auto slot = findSlot(first, second);
+    if (slot < 0)
+    {
+        return;
+    }
+    const auto index = m_index[slot];
+    eraseSlot(static_cast<size_t>(slot));
+
+    // the last entry fills the hole, its index slot is repointed
+    const auto last = static_cast<int32_t>(m_entries.size()) - 1;
+    if (index != last)
+    {
+        m_index[findSlot(m_entries[last].first, m_entries[last].second)] = index;
+        m_entries[index] = std::move(m_entries[last]);
+    }
+    m_entries.pop_back();
+}
+
+template<typename T, typename V>
+template<typename Callback>
+void PairTable<T, V>::retain(Callback&& callback)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        if (callback(m_entries[i]))
+        {
+            if (kept != i)
+            {
+                m_entries[kept] = std::move(m_entries[i]);
+            }
+            ++kept;
+        }
+    }
+    if (kept != m_entries.size())
+    {
+        m_entries.resize(kept);
+        rebuildIndex(m_index.size());
+    }
+}
+
+template<typename T, typename V>
+void PairTable<T, V>::eraseAll(T object)
+{
+    retain([object](const Entry& entry)
+    {
+        return entry.first != object && entry.second != object;
+    });
+}
+
+template<typename T, typename V>
+void PairTable<T, V>::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+template<typename T, typename V>
+size_t PairTable<T, V>::size() const
+{
+    return m_entries.size();
+}
+
+template<typename T, typename V>
+size_t PairTable<T, V>::hash(T first, T second)
+{
+    const uint64_t h1 = std::hash<T>{}(first);
+    const uint64_t h2 = std::hash<T>{}(second);
+    auto h = (h1 * 0x9E3779B97F4A7C15ull) ^ (h2 + 0x7F4A7C159E3779B9ull + (h1 << 6) + (h1 >> 2));
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+template<typename T, typename V>
+int32_t PairTable<T, V>::findIndex(T first, T second) const
+{
+    const auto slot = findSlot(first, second);
+    return slot >= 0 ? m_index[slot] : -1;
+}
+
+template<typename T, typename V>
+int32_t PairTable<T, V>::findSlot(T first, T second) const
+{
+    if (m_index.empty())
+    {
+        return -1;
+    }
+    const size_t mask = m_index.size() - 1;
+    for (size_t slot = hash(first, second) & mask;; slot = (slot + 1) & mask)
+    {
+        const auto index = m_index[slot];
+        if (index < 0)
+        {
+            return -1;
+        }
+        const auto& entry = m_entries[index];
+        if (entry.first == first && entry.second == second)
+        {
+            return static_cast<int32_t>(slot);
+        }
+    }
+}
+
+template<typename T, typename V>
+void PairTable<T, V>::eraseSlot(size_t slot)
+{
+    // backward shift deletion: later entries of the probe run move into the hole
+    // unless their home slot lies between the hole and their current slot
+    const size_t mask = m_index.size() - 1;
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; m_index[next] >= 0; next = (next + 1) & mask)
+    {
+        const auto& entry = m_entries[m_index[next]];
+        const size_t home = hash(entry.first, entry.second) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            m_index[hole] = m_index[next];
+            hole = next;
+        }
+    }
+    m_index[hole] = -1;
+}
+
+template<typename T, typename V>
+void PairTable<T, V>::rebuildIndex(size_t capacity)
+{
+    m_index.assign(capacity, -1);
+    if (capacity == 0)
+    {
+        return;
+    }
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        for (size_t slot = hash(m_entries[i].first, m_entries[i].second) & mask;; slot = (slot + 1) & mask)
+        {
+            if (m_index[slot] < 0)
+            {
+                m_index[slot] = static_cast<int32_t>(i);
+                break;
+            }
+        }
+    }
+}
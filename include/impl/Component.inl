@@ -19,6 +19,13 @@ protected:
 
 #define __W4_COMPONENT_DISABLE_CLONING public: struct __COMPONENT_NOT_CLONEABLE{};
 
+// after W4_COMPONENT: instances live in ComponentPool<Self> and can be walked with ComponentsSystem::forEach, derived components repeat it
+#define __W4_COMPONENT_POOLED                                                                                                                           \
+public:                                                                                                                                                 \
+    using __COMPONENT_POOLED_TYPE = Self;                                                                                                               \
+    static void* operator new(size_t size) { return ::w4::core::ComponentPool<Self>::instance().allocate(size); }                                      \
+    static void operator delete(void* ptr, size_t size) { ::w4::core::ComponentPool<Self>::instance().deallocate(ptr, size); }                         \
+
 namespace w4::core::details {
 
 template< typename ... Ts >
@@ -30,6 +37,12 @@ struct IsComponentCloneable : std::true_type {};
 template< typename T >
 struct IsComponentCloneable< T, void_t<typename T::__COMPONENT_NOT_CLONEABLE> > : std::false_type {};
 
+template< typename T, typename = void >
+struct IsComponentPooled : std::false_type {};
+
+template< typename T >
+struct IsComponentPooled< T, void_t<typename T::__COMPONENT_POOLED_TYPE> > : std::true_type {};
+
 }
 
 template<typename T>
@@ -60,6 +73,11 @@ void ::w4::core::ComponentsSystem::onComponentAdded(IComponent::RegisterTag, T *
 
     onComponentEnabled(component, component->isEnabled());
 
+    if constexpr (::w4::core::details::IsComponentPooled<T>::value)
+    {
+        static_assert(is_same_v<typename T::__COMPONENT_POOLED_TYPE, T>, "components derived from a pooled one need W4_COMPONENT_POOLED too");
+    }
+
     if ((void (T::*)(float)) &T::update != &IComponent::update) //if update fn is overloaded
     {
         if (component->isEnabled())
@@ -73,6 +91,36 @@ void ::w4::core::ComponentsSystem::onComponentAdded(IComponent::RegisterTag, T *
     }
 }
 
+template<typename T, typename F>
+void ::w4::core::ComponentsSystem::forEach(F&& f)
+{
+    static_assert(::w4::core::details::IsComponentPooled<T>::value, "forEach needs a W4_COMPONENT_POOLED component");
+
+    ComponentPool<T>::instance().forEach([&f](T& component)
+    {
+        if (component.isEnabled())
+        {
+            f(component);
+        }
+    });
+}
+
+template<typename T>
+::w4::core::ComponentHandle<T> w4::core::ComponentsSystem::getHandle(const T& component)
+{
+    static_assert(::w4::core::details::IsComponentPooled<T>::value, "handles need a W4_COMPONENT_POOLED component");
+
+    return ComponentPool<T>::instance().getHandle(component);
+}
+
+template<typename T>
+T* ::w4::core::ComponentsSystem::get(const ComponentHandle<T>& handle)
+{
+    static_assert(::w4::core::details::IsComponentPooled<T>::value, "handles need a W4_COMPONENT_POOLED component");
+
+    return ComponentPool<T>::instance().get(handle);
+}
+
 namespace std {
 
 template<>
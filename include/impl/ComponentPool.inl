@@ -0,0 +1,137 @@
+template<typename T>
+ComponentPool<T>& ComponentPool<T>::instance()
+{
+    static ComponentPool pool;
+    return pool;
+}
+
+template<typename T>
+void* ComponentPool<T>::allocate(size_t size)
+{
+    if (size != sizeof(T))
+    {
+        return ::operator new(size);
+    }
+
+    uint32_t index;
+    if (!m_free.empty())
+    {
+        // lowest freed slot first, live components stay packed at the front
+        std::pop_heap(m_free.begin(), m_free.end(), std::greater<uint32_t>());
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_generations.size());
+        if (index % ChunkSize == 0)
+        {
+            m_chunks.emplace_back(new Slot[ChunkSize]);
+            const std::pair<const Slot*, uint32_t> chunk{m_chunks.back().get(), static_cast<uint32_t>(m_chunks.size() - 1)};
+            m_chunksByAddress.insert(std::upper_bound(m_chunksByAddress.begin(), m_chunksByAddress.end(), chunk), chunk);
+        }
+        m_generations.push_back(0);
+        m_alive.push_back(0);
+    }
+
+    m_alive[index] = 1;
+    ++m_size;
+    return slot(index);
+}
+
+template<typename T>
+void ComponentPool<T>::deallocate(void* ptr, size_t size)
+{
+    if (size != sizeof(T))
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const auto index = findIndex(ptr);
+    W4_ASSERT(index != ComponentHandle<T>::InvalidIndex && m_alive[index]);
+    m_alive[index] = 0;
+    ++m_generations[index];
+    --m_size;
+    m_free.push_back(index);
+    std::push_heap(m_free.begin(), m_free.end(), std::greater<uint32_t>());
+}
+
+template<typename T>
+ComponentHandle<T> ComponentPool<T>::getHandle(const T& component) const
+{
+    const auto index = findIndex(&component);
+    if (index == ComponentHandle<T>::InvalidIndex || !m_alive[index])
+    {
+        return {};
+    }
+    return {index, m_generations[index]};
+}
+
+template<typename T>
+T* ComponentPool<T>::get(const ComponentHandle<T>& handle) const
+{
+    if (handle.index >= m_generations.size() || !m_alive[handle.index] || m_generations[handle.index] != handle.generation)
+    {
+        return nullptr;
+    }
+    return slot(handle.index);
+}
+
+template<typename T>
+template<typename F>
+void ComponentPool<T>::forEach(F&& f)
+{
+    // slots are only added at the end, the ones allocated by f are visited too
+    for (size_t chunk = 0; chunk < m_chunks.size(); ++chunk)
+    {
+        const auto first = chunk * ChunkSize;
+        const auto last = std::min(first + ChunkSize, m_alive.size());
+        auto* slots = m_chunks[chunk].get();
+        for (size_t i = first; i < last; ++i)
+        {
+            if (m_alive[i])
+            {
+                f(*std::launder(reinterpret_cast<T*>(slots[i - first].storage)));
+            }
+        }
+    }
+}
+
+template<typename T>
+size_t ComponentPool<T>::size() const
+{
+    return m_size;
+}
+
+template<typename T>
+size_t ComponentPool<T>::capacity() const
+{
+    return m_chunks.size() * ChunkSize;
+}
+
+template<typename T>
+T* ComponentPool<T>::slot(uint32_t index) const
+{
+    return std::launder(reinterpret_cast<T*>(m_chunks[index / ChunkSize][index % ChunkSize].storage));
+}
+
+template<typename T>
+uint32_t ComponentPool<T>::findIndex(const void* ptr) const
+{
+    const auto* address = static_cast<const Slot*>(ptr);
+    auto it = std::upper_bound(m_chunksByAddress.begin(), m_chunksByAddress.end(), address, [](const Slot* a, const std::pair<const Slot*, uint32_t>& chunk)
+    {
+        return std::less<const Slot*>()(a, chunk.first);
+    });
+    if (it == m_chunksByAddress.begin())
+    {
+        return ComponentHandle<T>::InvalidIndex;
+    }
+    --it;
+    if (!std::less<const Slot*>()(address, it->first + ChunkSize))
+    {
+        return ComponentHandle<T>::InvalidIndex;
+    }
+    return static_cast<uint32_t>(it->second * ChunkSize + (address - it->first));
+}
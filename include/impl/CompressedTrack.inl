@@ -0,0 +1,544 @@
+#include "FatalError.h"
+#include "W4Logger.h"
+
+namespace w4::resources {
+
+namespace detail {
+
+template<typename V>
+inline void writeArray(uint8_t*& cursor, const std::vector<V>& values)
+{
+    const auto count = static_cast<uint32_t>(values.size());
+    std::memcpy(cursor, &count, sizeof(count));
+    cursor += sizeof(count);
+    if (count)
+    {
+        std::memcpy(cursor, values.data(), count * sizeof(V));
+        cursor += count * sizeof(V);
+    }
+}
+
+template<typename V>
+inline bool readArray(const uint8_t*& cursor, const uint8_t* end, std::vector<V>& values)
+{
+    uint32_t count = 0;
+    if (end - cursor < static_cast<ptrdiff_t>(sizeof(count)))
+    {
+        return false;
+    }
+    std::memcpy(&count, cursor, sizeof(count));
+    cursor += sizeof(count);
+    if (static_cast<size_t>(end - cursor) < count * sizeof(V))
+    {
+        return false;
+    }
+    values.resize(count);
+    if (count)
+    {
+        std::memcpy(values.data(), cursor, count * sizeof(V));
+        cursor += count * sizeof(V);
+    }
+    return true;
+}
+
+inline uint16_t quantize(float value, float min, float scale)
+{
+    if (scale <= 0.f)
+    {
+        return 0;
+    }
+    return static_cast<uint16_t>(std::clamp(std::lround((value - min) / scale), 0l, 65535l));
+}
+
+} // namespace detail
+
+inline void TrackKeyCodec<math::Rotator>::split(const math::Rotator& value, float* out)
+{
+    out[0] = value.quaternion.x;
+    out[1] = value.quaternion.y;
+    out[2] = value.quaternion.z;
+    out[3] = value.quaternion.w;
+}
+
+inline math::Rotator TrackKeyCodec<math::Rotator>::join(const float* in)
+{
+    return math::Rotator(in[0], in[1], in[2], in[3]);
+}
+
+inline void TrackKeyCodec<math::Rotator>::encode(const float* quaternion, uint16_t* words)
+{
+    constexpr float range = 0.70710678f;  // the three smallest components are within +-1/sqrt(2)
+    constexpr float steps = 32767.f;
+
+    uint64_t largest = 0;
+    for (uint64_t i = 1; i < 4; ++i)
+    {
+        if (std::fabs(quaternion[i]) > std::fabs(quaternion[largest]))
+        {
+            largest = i;
+        }
+    }
+    // the sign of the dropped component is kept, so neighbouring keys stay in the hemisphere the track was authored in
+    uint64_t bits = largest | (quaternion[largest] < 0.f ? uint64_t(1) << 47 : 0);
+    uint32_t shift = 2;
+    for (uint64_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+        const auto normalized = (std::clamp(quaternion[i], -range, range) + range) / (2.f * range);
+        bits |= static_cast<uint64_t>(std::lround(normalized * steps)) << shift;
+        shift += 15;
+    }
+    words[0] = static_cast<uint16_t>(bits);
+    words[1] = static_cast<uint16_t>(bits >> 16);
+    words[2] = static_cast<uint16_t>(bits >> 32);
+}
+
+inline void TrackKeyCodec<math::Rotator>::decode(const uint16_t* words, float* quaternion)
+{
+    constexpr float range = 0.70710678f;
+    constexpr float steps = 32767.f;
+
+    const uint64_t bits = uint64_t(words[0]) | (uint64_t(words[1]) << 16) | (uint64_t(words[2]) << 32);
+    const auto largest = static_cast<size_t>(bits & 3);
+    uint32_t shift = 2;
+    float sum = 0.f;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+        const auto value = static_cast<float>((bits >> shift) & 0x7fff) / steps * (2.f * range) - range;
+        quaternion[i] = value;
+        sum += value * value;
+        shift += 15;
+    }
+    const auto largestValue = std::sqrt(std::max(0.f, 1.f - sum));
+    quaternion[largest] = (bits >> 47) & 1 ? -largestValue : largestValue;
+}
+
+template<typename T>
+CompressedTrack<T> CompressedTrack<T>::compress(const std::vector<Value>& values, const Options& options)
+{
+    CompressedTrack result;
+    const auto count = values.size();
+    result.m_count = static_cast<uint32_t>(count);
+    if (count == 0)
+    {
+        return result;
+    }
+
+    // times
+    result.m_startTime = values.front().time;
+    result.m_span = values.back().time - values.front().time;
+    result.m_step = count > 1 ? result.m_span / static_cast<float>(count - 1) : 0.f;
+    bool isUniform = true;
+    for (size_t i = 0; i < count && isUniform; ++i)
+    {
+        isUniform = std::fabs(values[i].time - (result.m_startTime + result.m_step * i)) <= options.timeTolerance * result.m_step;
+    }
+    if (!isUniform)
+    {
+        result.m_step = 0.f;
+        result.m_times.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            result.m_times[i] = detail::quantize(values[i].time - result.m_startTime, 0.f, result.m_span / 65535.f);
+        }
+    }
+
+    // values
+    std::vector<float> components(count * Codec::Floats);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Codec::split(values[i].value, components.data() + i * Codec::Floats);
+    }
+    result.m_values.resize(count * Codec::Words);
+    if constexpr (Codec::IsRotation)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Codec::encode(components.data() + i * Codec::Floats, result.m_values.data() + i * Codec::Words);
+        }
+    }
+    else
+    {
+        for (size_t c = 0; c < Codec::Floats; ++c)
+        {
+            auto min = components[c];
+            auto max = components[c];
+            for (size_t i = 1; i < count; ++i)
+            {
+                min = std::min(min, components[i * Codec::Floats + c]);
+                max = std::max(max, components[i * Codec::Floats + c]);
+            }
+            result.m_rangeMin[c] = min;
+            result.m_rangeScale[c] = (max - min) / 65535.f;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t c = 0; c < Codec::Floats; ++c)
+            {
+                result.m_values[i * Codec::Words + c] = detail::quantize(components[i * Codec::Floats + c], result.m_rangeMin[c], result.m_rangeScale[c]);
+            }
+        }
+    }
+
+    // interpolation types
+    result.m_interp = values.front().interp;
+    const auto isMixed = std::any_of(values.begin(), values.end(), [&result](const Value& v) { return v.interp != result.m_interp; });
+    if (isMixed)
+    {
+        result.m_interps.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            result.m_interps[i] = static_cast<uint8_t>(values[i].interp);
+        }
+    }
+
+    // tangents: a HERMIT segment reads tangents[1] of its first key and tangents[0] of the next one
+    auto needsTangents = [&values](size_t i)
+    {
+        return values[i].interp == InterpType::HERMIT || (i > 0 && values[i - 1].interp == InterpType::HERMIT);
+    };
+    auto pushTangents = [&result](const Value& value)
+    {
+        const auto offset = result.m_tangents.size();
+        result.m_tangents.resize(offset + 2 * Codec::Floats);
+        Codec::split(value.tangents[0], result.m_tangents.data() + offset);
+        Codec::split(value.tangents[1], result.m_tangents.data() + offset + Codec::Floats);
+    };
+    if (!isMixed && result.m_interp == InterpType::HERMIT)
+    {
+        result.m_allTangents = true;
+        for (const auto& value: values)
+        {
+            pushTangents(value);
+        }
+    }
+    else if (isMixed)
+    {
+        result.m_tangentsSlots.assign(count, NoTangents);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (needsTangents(i))
+            {
+                result.m_tangentsSlots[i] = static_cast<uint32_t>(result.m_tangents.size() / (2 * Codec::Floats));
+                pushTangents(values[i]);
+            }
+        }
+        if (result.m_tangents.empty())
+        {
+            result.m_tangentsSlots.clear();
+        }
+    }
+    return result;
+}
+
+template<typename T>
+std::vector<typename CompressedTrack<T>::Value> CompressedTrack<T>::decompress() const
+{
+    std::vector<Value> result;
+    result.reserve(m_count);
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        result.push_back(getKey(i));
+    }
+    return result;
+}
+
+template<typename T>
+size_t CompressedTrack<T>::size() const
+{
+    return m_count;
+}
+
+template<typename T>
+bool CompressedTrack<T>::empty() const
+{
+    return m_count == 0;
+}
+
+template<typename T>
+bool CompressedTrack<T>::isUniform() const
+{
+    return m_times.empty();
+}
+
+template<typename T>
+float CompressedTrack<T>::getTime(size_t index) const
+{
+    if (m_times.empty())
+    {
+        return m_startTime + m_step * static_cast<float>(index);
+    }
+    return m_startTime + static_cast<float>(m_times[index]) * (m_span / 65535.f);
+}
+
+template<typename T>
+T CompressedTrack<T>::getValue(size_t index) const
+{
+    float components[Codec::Floats];
+    const auto* words = m_values.data() + index * Codec::Words;
+    if constexpr (Codec::IsRotation)
+    {
+        Codec::decode(words, components);
+    }
+    else
+    {
+        for (size_t c = 0; c < Codec::Floats; ++c)
+        {
+            components[c] = m_rangeMin[c] + static_cast<float>(words[c]) * m_rangeScale[c];
+        }
+    }
+    return Codec::join(components);
+}
+
+template<typename T>
+InterpType CompressedTrack<T>::getInterp(size_t index) const
+{
+    return m_interps.empty() ? m_interp : static_cast<InterpType>(m_interps[index]);
+}
+
+template<typename T>
+typename CompressedTrack<T>::Value CompressedTrack<T>::getKey(size_t index) const
+{
+    Value result;
+    result.time = getTime(index);
+    result.value = getValue(index);
+    result.interp = getInterp(index);
+    const auto slot = getTangentsSlot(index);
+    if (slot != NoTangents)
+    {
+        const auto* tangents = m_tangents.data() + slot * 2 * Codec::Floats;
+        result.tangents[0] = Codec::join(tangents);
+        result.tangents[1] = Codec::join(tangents + Codec::Floats);
+    }
+    else
+    {
+        result.tangents[0] = result.tangents[1] = T();
+    }
+    return result;
+}
+
+template<typename T>
+size_t CompressedTrack<T>::upperBound(float time) const
+{
+    if (m_count == 0 || time < m_startTime)
+    {
+        return 0;
+    }
+    if (m_times.empty())
+    {
+        if (m_step <= 0.f)
+        {
+            return m_count;
+        }
+        // implied times: direct index, then fixed for rounding at the key boundaries
+        auto index = std::min(static_cast<size_t>((time - m_startTime) / m_step) + 1, static_cast<size_t>(m_count));
+        while (index < m_count && getTime(index) <= time)
+        {
+            ++index;
+        }
+        while (index > 0 && getTime(index - 1) > time)
+        {
+            --index;
+        }
+        return index;
+    }
+    const auto quantized = (time - m_startTime) / (m_span / 65535.f);
+    if (quantized >= 65535.f)
+    {
+        return m_count;
+    }
+    const auto key = static_cast<uint16_t>(quantized);
+    return std::upper_bound(m_times.begin(), m_times.end(), key) - m_times.begin();
+}
+
+template<typename T>
+T CompressedTrack<T>::sample(float time) const
+{
+    if (m_count == 0)
+    {
+        return T();
+    }
+    if (m_count == 1)
+    {
+        return getValue(0);
+    }
+
+    const auto current = std::min(std::max<size_t>(upperBound(time), 1) - 1, static_cast<size_t>(m_count) - 2);
+    const auto a = getKey(current);
+    if (a.interp == InterpType::CONST)
+    {
+        return a.value;
+    }
+    const auto b = getKey(current + 1);
+    const auto delta = b.time > a.time ? std::clamp((time - a.time) / (b.time - a.time), 0.0f, 1.0f) : 0.0f;
+
+    switch (a.interp)
+    {
+        case InterpType::CONST:
+            return a.value;
+        case InterpType::LERP:
+            return LerpInterpolate<T>::interpolate(a, b, delta);
+        case InterpType::HERMIT:
+            return HermitInterpolate<T>::interpolate(a, b, delta);
+        case InterpType::CUBIC:
+            return CubicInterpolate<T>::interpolate(getKeyByOffset(current, -2), getKeyByOffset(current, -1), a, b, delta);
+    }
+
+    return T();
+}
+
+template<typename T>
+size_t CompressedTrack<T>::getMemorySize() const
+{
+    return sizeof(*this)
+        + m_times.capacity() * sizeof(uint16_t)
+        + m_values.capacity() * sizeof(uint16_t)
+        + m_interps.capacity() * sizeof(uint8_t)
+        + m_tangentsSlots.capacity() * sizeof(uint32_t)
+        + m_tangents.capacity() * sizeof(float);
+}
+
+template<typename T>
+size_t CompressedTrack<T>::binarySize() const
+{
+    return sizeof(m_count) + 3 * sizeof(float) + 2 * Codec::Floats * sizeof(float) + 2 * sizeof(uint8_t)
+        + sizeof(uint32_t) + m_times.size() * sizeof(uint16_t)
+        + sizeof(uint32_t) + m_values.size() * sizeof(uint16_t)
+        + sizeof(uint32_t) + m_interps.size() * sizeof(uint8_t)
+        + sizeof(uint32_t) + m_tangentsSlots.size() * sizeof(uint32_t)
+        + sizeof(uint32_t) + m_tangents.size() * sizeof(float);
+}
+
+template<typename T>
+size_t CompressedTrack<T>::toBinary(void* destination, size_t bufferSize) const
+{
+    const auto size = binarySize();
+    if (bufferSize < size)
+    {
+        W4_LOG_ERROR("CompressedTrack: buffer is too small, %zu of %zu bytes", bufferSize, size);
+        return 0;
+    }
+
+    auto* cursor = static_cast<uint8_t*>(destination);
+    auto write = [&cursor](const void* data, size_t bytes)
+    {
+        std::memcpy(cursor, data, bytes);
+        cursor += bytes;
+    };
+    const uint8_t interp = static_cast<uint8_t>(m_interp);
+    const uint8_t allTangents = m_allTangents ? 1 : 0;
+    write(&m_count, sizeof(m_count));
+    write(&m_startTime, sizeof(float));
+    write(&m_step, sizeof(float));
+    write(&m_span, sizeof(float));
+    write(m_rangeMin.data(), Codec::Floats * sizeof(float));
+    write(m_rangeScale.data(), Codec::Floats * sizeof(float));
+    write(&interp, sizeof(interp));
+    write(&allTangents, sizeof(allTangents));
+    detail::writeArray(cursor, m_times);
+    detail::writeArray(cursor, m_values);
+    detail::writeArray(cursor, m_interps);
+    detail::writeArray(cursor, m_tangentsSlots);
+    detail::writeArray(cursor, m_tangents);
+    return size;
+}
+
+template<typename T>
+void CompressedTrack<T>::fromBinary(const void* source, size_t bufferSize)
+{
+    const auto* cursor = static_cast<const uint8_t*>(source);
+    const auto* end = cursor + bufferSize;
+    constexpr auto headerSize = sizeof(uint32_t) + 3 * sizeof(float) + 2 * Codec::Floats * sizeof(float) + 2 * sizeof(uint8_t);
+    if (bufferSize < headerSize)
+    {
+        FATAL_ERROR("CompressedTrack: truncated header, %zu bytes", bufferSize);
+    }
+
+    auto read = [&cursor](void* data, size_t bytes)
+    {
+        std::memcpy(data, cursor, bytes);
+        cursor += bytes;
+    };
+    uint8_t interp = 0;
+    uint8_t allTangents = 0;
+    read(&m_count, sizeof(m_count));
+    read(&m_startTime, sizeof(float));
+    read(&m_step, sizeof(float));
+    read(&m_span, sizeof(float));
+    read(m_rangeMin.data(), Codec::Floats * sizeof(float));
+    read(m_rangeScale.data(), Codec::Floats * sizeof(float));
+    read(&interp, sizeof(interp));
+    read(&allTangents, sizeof(allTangents));
+    m_interp = static_cast<InterpType>(interp);
+    m_allTangents = allTangents != 0;
+
+    if (!detail::readArray(cursor, end, m_times)
+        || !detail::readArray(cursor, end, m_values)
+        || !detail::readArray(cursor, end, m_interps)
+        || !detail::readArray(cursor, end, m_tangentsSlots)
+        || !detail::readArray(cursor, end, m_tangents)
+        || m_values.size() != static_cast<uint64_t>(m_count) * Codec::Words)
+    {
+        FATAL_ERROR("CompressedTrack: corrupted data");
+    }
+    // every per key array is indexed by key without further checks
+    if (!m_times.empty() && m_times.size() != m_count)
+    {
+        FATAL_ERROR("CompressedTrack: %zu times for %u keys", m_times.size(), m_count);
+    }
+    if (!m_interps.empty() && m_interps.size() != m_count)
+    {
+        FATAL_ERROR("CompressedTrack: %zu interpolation types for %u keys", m_interps.size(), m_count);
+    }
+    if (!m_tangentsSlots.empty() && m_tangentsSlots.size() != m_count)
+    {
+        FATAL_ERROR("CompressedTrack: %zu tangent slots for %u keys", m_tangentsSlots.size(), m_count);
+    }
+    const auto slotsCount = m_tangents.size() / (2 * Codec::Floats);
+    if (m_tangents.size() % (2 * Codec::Floats) != 0)
+    {
+        FATAL_ERROR("CompressedTrack: %zu tangent floats do not make whole slots", m_tangents.size());
+    }
+    for (auto slot: m_tangentsSlots)
+    {
+        if (slot != NoTangents && slot >= slotsCount)
+        {
+            FATAL_ERROR("CompressedTrack: tangent slot %u out of %zu", slot, slotsCount);
+        }
+    }
+    if (m_allTangents && slotsCount != m_count)
+    {
+        FATAL_ERROR("CompressedTrack: %zu tangent slots for %u keys", slotsCount, m_count);
+    }
+}
+
+template<typename T>
+uint32_t CompressedTrack<T>::getTangentsSlot(size_t index) const
+{
+    if (m_allTangents)
+    {
+        return static_cast<uint32_t>(index);
+    }
+    return m_tangentsSlots.empty() ? NoTangents : m_tangentsSlots[index];
+}
+
+// same wrapping as Track::getValueByOffset
+template<typename T>
+typename CompressedTrack<T>::Value CompressedTrack<T>::getKeyByOffset(size_t index, int offset) const
+{
+    const auto newIndex = static_cast<int>(index) + offset;
+    if (newIndex < 0)
+    {
+        return getKey(m_count + newIndex);
+    }
+    return getKey(static_cast<size_t>(newIndex) % m_count);
+}
+
+} // namespace w4::resources
@@ -0,0 +1,127 @@
+inline InputCoalescer::InputCoalescer(TouchMovesHandler onTouchMoves)
+    : m_onTouchMoves(std::move(onTouchMoves))
+{
+    m_gamepadAxes.fill(std::numeric_limits<float>::quiet_NaN());
+}
+
+inline void InputCoalescer::onTouchBegin(const event::Touch::Begin& event)
+{
+    ++m_rawCount;
+    flushFinger(getFinger(event.touchId));
+}
+
+inline void InputCoalescer::onTouchMove(const event::Touch::Move& event)
+{
+    ++m_rawCount;
+    getFinger(event.touchId).points.push_back(event.point);
+}
+
+inline void InputCoalescer::onTouchEnd(const event::Touch::End& event)
+{
+    ++m_rawCount;
+    const auto it = std::find_if(m_fingers.begin(), m_fingers.end(), [&event](const Finger& finger) { return finger.touchId == event.touchId; });
+    if (it != m_fingers.end())
+    {
+        flushFinger(*it);
+        m_fingers.erase(it);
+    }
+}
+
+template<typename AxisEvent>
+void InputCoalescer::onAxis(const AxisEvent& event)
+{
+    ++m_rawCount;
+    getAxis(AxisEvent::typeInfo.hash()).value = event.value;
+}
+
+inline void InputCoalescer::flushTouchMoves()
+{
+    for (auto& finger : m_fingers)
+    {
+        flushFinger(finger);
+    }
+}
+
+template<typename AxisEvent, typename F>
+void InputCoalescer::flushAxis(F&& f)
+{
+    auto& axis = getAxis(AxisEvent::typeInfo.hash());
+    // NaN until the first event, compares unequal to everything
+    if (axis.value != axis.value || axis.value == axis.flushedValue)
+    {
+        return;
+    }
+    axis.flushedValue = axis.value;
+    ++m_flushedCount;
+    f(AxisEvent(axis.value));
+}
+
+template<typename F>
+void InputCoalescer::flushGamepadAxes(F&& f)
+{
+    const auto& gamepad = Input::gamepad();
+    const auto count = std::min<size_t>(gamepad.getInfo().axes, MAX_GAMEPAD_AXES);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto value = gamepad.getAxis(i);
+        if (value == m_gamepadAxes[i])
+        {
+            continue;
+        }
+        m_gamepadAxes[i] = value;
+        ++m_flushedCount;
+        f(i, value);
+    }
+}
+
+inline void InputCoalescer::clear()
+{
+    m_fingers.clear();
+    m_axes.clear();
+    m_gamepadAxes.fill(std::numeric_limits<float>::quiet_NaN());
+}
+
+inline size_t InputCoalescer::getRawCount() const
+{
+    return m_rawCount;
+}
+
+inline size_t InputCoalescer::getFlushedCount() const
+{
+    return m_flushedCount;
+}
+
+inline InputCoalescer::Finger& InputCoalescer::getFinger(int touchId)
+{
+    auto it = std::find_if(m_fingers.begin(), m_fingers.end(), [touchId](const Finger& finger) { return finger.touchId == touchId; });
+    if (it == m_fingers.end())
+    {
+        it = m_fingers.insert(m_fingers.end(), {touchId, {}});
+    }
+    return *it;
+}
+
+inline void InputCoalescer::flushFinger(Finger& finger)
+{
+    if (finger.points.empty())
+    {
+        return;
+    }
+    ++m_flushedCount;
+    if (m_onTouchMoves)
+    {
+        m_onTouchMoves(finger.touchId, finger.points.back(), finger.points);
+    }
+    finger.points.clear();
+}
+
+inline InputCoalescer::Axis& InputCoalescer::getAxis(core::TypeInfo::HashType type)
+{
+    auto it = std::find_if(m_axes.begin(), m_axes.end(), [type](const Axis& axis) { return axis.type == type; });
+    if (it == m_axes.end())
+    {
+        constexpr auto none = std::numeric_limits<float>::quiet_NaN();
+        it = m_axes.insert(m_axes.end(), {type, none, none});
+    }
+    return *it;
+}
@@ -75,6 +75,7 @@ void Node::removeComponent(const IComponent::Id& id)
         , getTypeInfo().name()
         , T::typeInfo.name()
         , id.value);
+        return;
     }
     it->second->finalize();
 
@@ -0,0 +1,310 @@
+namespace detail {
+
+inline void* lzmaAlloc(ISzAllocPtr, size_t size)
+{
+    return ::malloc(size);
+}
+
+inline void lzmaFree(ISzAllocPtr, void* address)
+{
+    ::free(address);
+}
+
+inline const ISzAlloc lzmaAllocator = {lzmaAlloc, lzmaFree};
+
+} // namespace detail
+
+inline PackageReader::PackageReader(size_t cachedBlocks)
+    : m_cachedBlocks(std::max<size_t>(cachedBlocks, 1))
+{}
+
+inline bool PackageReader::open(const sptr<filesystem::Stream>& stream)
+{
+    close();
+    if (!stream || !stream->good())
+    {
+        return false;
+    }
+    m_stream = stream;
+    if (!parse(stream->data(), stream->size()))
+    {
+        W4_LOG_ERROR("'%s' is not a valid w4pack", stream->getPath().c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+inline void PackageReader::close()
+{
+    m_stream = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+    m_files.clear();
+    m_filesByName.clear();
+    m_blocks.clear();
+    m_cache.clear();
+    m_stats = {};
+}
+
+inline bool PackageReader::isChunked() const
+{
+    return m_isChunked;
+}
+
+inline const PackageReader::File* PackageReader::find(const std::string& name) const
+{
+    auto it = m_filesByName.find(name);
+    return it != m_filesByName.end() ? &m_files[it->second] : nullptr;
+}
+
+inline const std::vector<PackageReader::File>& PackageReader::getFiles() const
+{
+    return m_files;
+}
+
+inline bool PackageReader::read(const File& file, std::vector<uint8_t>& result)
+{
+    result.resize(file.size);
+    if (!file.isPacked)
+    {
+        if (static_cast<uint64_t>(m_rawBegin) + file.offset + file.size > m_size)
+        {
+            return false;
+        }
+        std::copy_n(m_data + m_rawBegin + file.offset, file.size, result.data());
+        return true;
+    }
+
+    // copy the covered part of every block the file spans
+    uint32_t copied = 0;
+    while (copied < file.size)
+    {
+        const uint32_t position = file.offset + copied;
+        const uint32_t blockIndex = position / m_blockSize;
+        const auto* block = getBlock(blockIndex);
+        if (!block)
+        {
+            return false;
+        }
+        const uint32_t inBlock = position - blockIndex * m_blockSize;
+        const uint32_t count = std::min<uint32_t>(file.size - copied, static_cast<uint32_t>(block->size()) - inBlock);
+        std::copy_n(block->data() + inBlock, count, result.data() + copied);
+        copied += count;
+    }
+    return true;
+}
+
+inline bool PackageReader::read(const std::string& name, std::vector<uint8_t>& result)
+{
+    if (auto file = find(name))
+    {
+        return read(*file, result);
+    }
+    return false;
+}
+
+inline bool PackageReader::readAssetFile(const ResourceFileDescription& description, std::vector<uint8_t>& result)
+{
+    return read(description.getAssetFilePath(), result);
+}
+
+inline const PackageReader::Stats& PackageReader::getStats() const
+{
+    return m_stats;
+}
+
+inline const std::vector<uint8_t>* PackageReader::getBlock(uint32_t index)
+{
+    if (index >= m_blocks.size())
+    {
+        return nullptr;
+    }
+    ++m_useCounter;
+    for (auto& cached: m_cache)
+    {
+        if (cached.index == index)
+        {
+            cached.lastUse = m_useCounter;
+            ++m_stats.cacheHits;
+            return &cached.data;
+        }
+    }
+
+    // evict the least recently used block, its buffer is reused for the new one
+    CachedBlock* slot;
+    if (m_cache.size() < m_cachedBlocks)
+    {
+        slot = &m_cache.emplace_back();
+    }
+    else
+    {
+        slot = &*std::min_element(m_cache.begin(), m_cache.end(), [](const CachedBlock& lh, const CachedBlock& rh)
+        {
+            return lh.lastUse < rh.lastUse;
+        });
+    }
+    slot->index = index;
+    slot->lastUse = m_useCounter;
+    if (!decodeBlock(index, slot->data))
+    {
+        W4_LOG_ERROR("'%s': failed to decode block %u", m_stream->getPath().c_str(), index);
+        slot->index = std::numeric_limits<uint32_t>::max();
+        slot->data.clear();
+        return nullptr;
+    }
+    ++m_stats.blocksDecoded;
+    m_stats.bytesDecoded += slot->data.size();
+    return &slot->data;
+}
+
+inline bool PackageReader::decodeBlock(uint32_t index, std::vector<uint8_t>& result) const
+{
+    const auto& block = m_blocks[index];
+    const size_t expected = std::min<size_t>(m_blockSize, m_decompressedSize - static_cast<size_t>(index) * m_blockSize);
+    result.resize(expected);
+
+    const Byte* src = m_data + m_comprBegin + block.comprOffset;
+    SizeT srcLen = block.comprSize;
+    SizeT destLen = expected;
+    ELzmaStatus status;
+    SRes res;
+    if (m_isChunked)
+    {
+        res = Lzma2Decode(result.data(), &destLen, src, &srcLen, m_dictProp, LZMA_FINISH_END, &status, &detail::lzmaAllocator);
+    }
+    else
+    {
+        // .lzma (alone) stream: 5 bytes of properties and 8 bytes of unpacked size
+        constexpr size_t aloneHeaderSize = LZMA_PROPS_SIZE + 8;
+        if (srcLen < aloneHeaderSize)
+        {
+            return false;
+        }
+        srcLen -= aloneHeaderSize;
+        res = LzmaDecode(result.data(), &destLen, src + aloneHeaderSize, &srcLen, src, LZMA_PROPS_SIZE, LZMA_FINISH_ANY, &status, &detail::lzmaAllocator);
+    }
+    return res == SZ_OK && destLen == expected;
+}
+
+inline bool PackageReader::parse(const uint8_t* data, size_t size)
+{
+    m_data = data;
+    m_size = size;
+
+    size_t pos = 0;
+    auto readU32 = [&](uint32_t& value)
+    {
+        if (pos + sizeof(uint32_t) > size)
+        {
+            return false;
+        }
+        std::memcpy(&value, data + pos, sizeof(uint32_t));
+        pos += sizeof(uint32_t);
+        return true;
+    };
+    auto readString = [&](std::string& value)
+    {
+        uint32_t length;
+        if (!readU32(length) || pos + length > size)
+        {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return true;
+    };
+
+    uint32_t magic;
+    if (!readU32(magic) || (magic != MagicLegacy && magic != MagicChunked))
+    {
+        return false;
+    }
+    m_isChunked = magic == MagicChunked;
+
+    uint32_t comprSize = 0;
+    uint32_t blocksCount = 1;
+    uint32_t dictProp = 0;
+    if (m_isChunked)
+    {
+        // LZMA2 dictionary properties above 40 are invalid
+        if (!readU32(m_blockSize) || !readU32(dictProp) || !readU32(blocksCount) || m_blockSize == 0 || dictProp > 40)
+        {
+            return false;
+        }
+        m_dictProp = static_cast<uint8_t>(dictProp);
+    }
+    else if (!readU32(comprSize))
+    {
+        return false;
+    }
+
+    uint32_t packedCount;
+    uint32_t rawCount;
+    if (!readU32(m_decompressedSize) || !readU32(packedCount) || !readU32(rawCount))
+    {
+        return false;
+    }
+    if (!m_isChunked)
+    {
+        m_blockSize = std::max<uint32_t>(m_decompressedSize, 1);
+        blocksCount = m_decompressedSize ? 1 : 0;
+    }
+    // exactly the blocks covering the decompressed data, decodeBlock() sizes its output from them
+    if (blocksCount != (static_cast<uint64_t>(m_decompressedSize) + m_blockSize - 1) / m_blockSize)
+    {
+        return false;
+    }
+
+    // a file entry takes at least 16 bytes, a block entry 8: counts the data cannot hold are rejected before allocating
+    if (static_cast<uint64_t>(packedCount) + rawCount > (size - pos) / 16)
+    {
+        return false;
+    }
+    m_files.resize(static_cast<size_t>(packedCount) + rawCount);
+    for (uint32_t i = 0; i < m_files.size(); ++i)
+    {
+        auto& file = m_files[i];
+        if (!readString(file.name) || !readString(file.mimeType) || !readU32(file.offset) || !readU32(file.size))
+        {
+            return false;
+        }
+        file.isPacked = i < packedCount;
+        if (file.isPacked && static_cast<uint64_t>(file.offset) + file.size > m_decompressedSize)
+        {
+            return false;
+        }
+        m_filesByName.emplace(file.name, i);
+    }
+
+    if (m_isChunked && blocksCount > (size - pos) / 8)
+    {
+        return false;
+    }
+    m_blocks.resize(blocksCount);
+    uint64_t comprEnd = comprSize;
+    if (m_isChunked)
+    {
+        for (auto& block: m_blocks)
+        {
+            if (!readU32(block.comprOffset) || !readU32(block.comprSize))
+            {
+                return false;
+            }
+            // 64-bit sum, a crafted offset + size must not wrap around the bounds check below
+            comprEnd = std::max(comprEnd, static_cast<uint64_t>(block.comprOffset) + block.comprSize);
+        }
+    }
+    else if (blocksCount)
+    {
+        m_blocks[0] = {0, comprSize};
+    }
+
+    if (comprEnd > size - pos)
+    {
+        return false;
+    }
+    m_comprBegin = pos;
+    m_rawBegin = pos + static_cast<size_t>(comprEnd);
+    return true;
+}
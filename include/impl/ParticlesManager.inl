@@ -0,0 +1,320 @@
+inline void ParticlesBatcher::begin()
+{
+    m_entries.clear();
+    m_batches.clear();
+    m_particlesCount = 0;
+}
+
+inline void ParticlesBatcher::add(const ParticlesSimulation& simulation, const math::mat4& world, float depthStep)
+{
+    if (simulation.hasActiveParticles())
+    {
+        m_entries.push_back({&simulation, world, depthStep});
+    }
+}
+
+inline void ParticlesBatcher::end()
+{
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b)
+    {
+        return isBatchLess(a.simulation->getParameters(), b.simulation->getParameters());
+    });
+
+    m_particlesCount = 0;
+    for (const auto& entry : m_entries)
+    {
+        m_particlesCount += entry.simulation->size();
+    }
+    // keeps its capacity, nothing is allocated once the effects peak
+    m_vertices.resize(m_particlesCount * ParticlesSimulation::VerticesPerParticle);
+
+    size_t particle = 0;
+    const ParticlesEmitterParameters* batchParameters = nullptr;
+    for (const auto& entry : m_entries)
+    {
+        const auto& parameters = entry.simulation->getParameters();
+        if (!batchParameters || !isSameBatch(*batchParameters, parameters))
+        {
+            m_batches.push_back({parameters.texture.get(), parameters.blendFunc, static_cast<uint32_t>(particle), 0, 0});
+            batchParameters = &parameters;
+        }
+
+        auto* vertices = m_vertices.data() + particle * ParticlesSimulation::VerticesPerParticle;
+        const auto count = entry.simulation->writeVertices(vertices, entry.depthStep, entry.world) / ParticlesSimulation::VerticesPerParticle;
+        auto& batch = m_batches.back();
+        batch.particlesCount += static_cast<uint32_t>(count);
+        ++batch.emittersCount;
+        particle += count;
+    }
+}
+
+inline const std::vector<ParticlesBatcher::Batch>& ParticlesBatcher::getBatches() const
+{
+    return m_batches;
+}
+
+inline const std::vector<ParticlesVertexFormat>& ParticlesBatcher::getVertices() const
+{
+    return m_vertices;
+}
+
+inline size_t ParticlesBatcher::getParticlesCount() const
+{
+    return m_particlesCount;
+}
+
+template<typename Index>
+void ParticlesBatcher::writeIndices(std::vector<Index>& out, size_t particlesCount)
+{
+    W4_ASSERT(particlesCount * ParticlesSimulation::VerticesPerParticle <= static_cast<size_t>(std::numeric_limits<Index>::max()) + 1);
+    out.resize(particlesCount * ParticlesSimulation::IndicesPerParticle);
+    ParticlesSimulation::writeIndices(out.data(), particlesCount);
+}
+
+inline bool ParticlesBatcher::isSameBatch(const ParticlesEmitterParameters& a, const ParticlesEmitterParameters& b)
+{
+    return a.texture == b.texture && a.blendFunc.src == b.blendFunc.src && a.blendFunc.dst == b.blendFunc.dst;
+}
+
+inline bool ParticlesBatcher::isBatchLess(const ParticlesEmitterParameters& a, const ParticlesEmitterParameters& b)
+{
+    if (a.texture != b.texture)
+    {
+        return std::less<resources::Texture*>()(a.texture.get(), b.texture.get());
+    }
+    if (a.blendFunc.src != b.blendFunc.src)
+    {
+        return a.blendFunc.src < b.blendFunc.src;
+    }
+    return a.blendFunc.dst < b.blendFunc.dst;
+}
+
+inline ParticlesManager& ParticlesManager::instance()
+{
+    static ParticlesManager manager;
+    return manager;
+}
+
+inline ParticlesManager::EffectId ParticlesManager::play(const Parameters& parameters, const math::mat4& world)
+{
+    uptr<ParticlesSimulation> simulation;
+    if (m_pooledSimulations.empty())
+    {
+        simulation = std::make_unique<ParticlesSimulation>();
+    }
+    else
+    {
+        simulation = std::move(m_pooledSimulations.back());
+        m_pooledSimulations.pop_back();
+    }
+
+    const auto id = m_nextEffectId++;
+    if (m_nextEffectId == InvalidEffect)
+    {
+        ++m_nextEffectId;
+    }
+
+    // the channels keep the capacity of the largest effect they served
+    simulation->setParameters(parameters);
+    simulation->setSeed(id * 2654435761u);
+    simulation->start();
+
+    m_effectsIndices[id] = m_effects.size();
+    m_effects.push_back({id, std::move(simulation), world});
+    return id;
+}
+
+inline void ParticlesManager::setTransform(EffectId effect, const math::mat4& world)
+{
+    if (auto* found = findEffect(effect))
+    {
+        found->world = world;
+    }
+}
+
+inline void ParticlesManager::stop(EffectId effect)
+{
+    if (auto* found = findEffect(effect))
+    {
+        found->simulation->stop();
+    }
+}
+
+inline void ParticlesManager::kill(EffectId effect)
+{
+    const auto it = m_effectsIndices.find(effect);
+    if (it != m_effectsIndices.end())
+    {
+        removeEffect(it->second);
+    }
+}
+
+inline bool ParticlesManager::isAlive(EffectId effect) const
+{
+    return findEffect(effect) != nullptr;
+}
+
+inline sptr<ParticlesEmitter> ParticlesManager::acquireEmitter(const resources::ResourceFileDescription& source, cref<core::Node> parent)
+{
+    auto key = getSourceKey(source);
+    sptr<ParticlesEmitter> emitter;
+    auto& pool = m_pooledEmitters[key];
+    if (pool.empty())
+    {
+        emitter = ParticlesEmitter::get(source);
+        ++m_clonedEmitters;
+    }
+    else
+    {
+        emitter = std::move(pool.back());
+        pool.pop_back();
+    }
+
+    if (parent)
+    {
+        parent->addChild(emitter);
+    }
+    emitter->start();
+    m_emitters.push_back({emitter, std::move(key), parent, false});
+    return emitter;
+}
+
+inline void ParticlesManager::releaseEmitter(cref<ParticlesEmitter> emitter)
+{
+    const auto it = std::find_if(m_emitters.begin(), m_emitters.end(), [&emitter](const ActiveEmitter& active)
+    {
+        return active.emitter == emitter;
+    });
+    if (it == m_emitters.end())
+    {
+        W4_LOG_WARNING("ParticlesManager: emitter '%s' was not acquired from the manager", emitter->getName().c_str());
+        return;
+    }
+    it->isReleased = true;
+    emitter->stop();
+}
+
+inline void ParticlesManager::update(float dt)
+{
+    for (size_t i = 0; i < m_effects.size();)
+    {
+        auto& simulation = *m_effects[i].simulation;
+        simulation.update(dt, m_effects[i].world);
+        if (!simulation.isEmitting() && !simulation.hasActiveParticles())
+        {
+            removeEffect(i);
+            continue;
+        }
+        ++i;
+    }
+
+    for (size_t i = 0; i < m_emitters.size();)
+    {
+        auto& active = m_emitters[i];
+        if (active.isReleased && active.emitter->getState() == ParticlesEmitter::State::IDLE && !active.emitter->hasActiveParticles())
+        {
+            if (detachEmitter(active))
+            {
+                m_pooledEmitters[active.source].push_back(std::move(active.emitter));
+            }
+            active = std::move(m_emitters.back());
+            m_emitters.pop_back();
+            continue;
+        }
+        ++i;
+    }
+
+    m_batcher.begin();
+    for (const auto& effect : m_effects)
+    {
+        m_batcher.add(*effect.simulation, effect.world, 0.f);
+    }
+    m_batcher.end();
+}
+
+inline void ParticlesManager::clear()
+{
+    m_effects.clear();
+    m_effectsIndices.clear();
+    m_pooledSimulations.clear();
+
+    for (auto& active : m_emitters)
+    {
+        if (active.isReleased)
+        {
+            detachEmitter(active);
+        }
+    }
+    m_emitters.clear();
+    m_pooledEmitters.clear();
+
+    m_batcher.begin();
+    m_batcher.end();
+}
+
+inline const ParticlesBatcher& ParticlesManager::getBatcher() const
+{
+    return m_batcher;
+}
+
+inline ParticlesManager::Stats ParticlesManager::getStats() const
+{
+    Stats result;
+    result.effects = static_cast<uint32_t>(m_effects.size());
+    result.particles = static_cast<uint32_t>(m_batcher.getParticlesCount());
+    result.batches = static_cast<uint32_t>(m_batcher.getBatches().size());
+    result.pooledSimulations = static_cast<uint32_t>(m_pooledSimulations.size());
+    result.emitters = static_cast<uint32_t>(m_emitters.size());
+    for (const auto& [source, pool] : m_pooledEmitters)
+    {
+        result.pooledEmitters += static_cast<uint32_t>(pool.size());
+    }
+    result.clonedEmitters = m_clonedEmitters;
+    return result;
+}
+
+inline std::string ParticlesManager::getSourceKey(const resources::ResourceFileDescription& source)
+{
+    return source.getAssetFilePath() + ":" + source.getPathInAsset();
+}
+
+inline ParticlesManager::Effect* ParticlesManager::findEffect(EffectId effect)
+{
+    const auto it = m_effectsIndices.find(effect);
+    return it == m_effectsIndices.end() ? nullptr : &m_effects[it->second];
+}
+
+inline const ParticlesManager::Effect* ParticlesManager::findEffect(EffectId effect) const
+{
+    const auto it = m_effectsIndices.find(effect);
+    return it == m_effectsIndices.end() ? nullptr : &m_effects[it->second];
+}
+
+inline bool ParticlesManager::detachEmitter(const ActiveEmitter& active)
+{
+    const auto parent = active.emitter->getParent();
+    if (parent != active.parent.lock())
+    {
+        return false;
+    }
+    if (parent)
+    {
+        parent->removeChild(active.emitter);
+    }
+    return true;
+}
+
+inline void ParticlesManager::removeEffect(size_t index)
+{
+    auto& effect = m_effects[index];
+    m_effectsIndices.erase(effect.id);
+    effect.simulation->clear();
+    m_pooledSimulations.push_back(std::move(effect.simulation));
+
+    if (index + 1 != m_effects.size())
+    {
+        effect = std::move(m_effects.back());
+        m_effectsIndices[effect.id] = index;
+    }
+    m_effects.pop_back();
+}
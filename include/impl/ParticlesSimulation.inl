@@ -0,0 +1,717 @@
+inline void ParticlesSpawner::setParameters(const Parameters& parameters)
+{
+    m_parameters = parameters;
+}
+
+inline void ParticlesSpawner::start()
+{
+    m_isEmitting = true;
+    m_elapsed = 0.f;
+    m_emitCounter = 0.f;
+}
+
+inline void ParticlesSpawner::stop()
+{
+    m_isEmitting = false;
+}
+
+inline bool ParticlesSpawner::isEmitting() const
+{
+    return m_isEmitting;
+}
+
+inline size_t ParticlesSpawner::advance(float dt)
+{
+    const auto lifeSpan = m_parameters.particleLifeSpan.value;
+    if (!m_isEmitting || lifeSpan <= 0.f || m_parameters.maxParticles == 0)
+    {
+        return 0;
+    }
+
+    // the pool is refilled over one life span
+    const auto interval = lifeSpan / static_cast<float>(m_parameters.maxParticles);
+    m_emitCounter += dt;
+    const auto count = static_cast<size_t>(m_emitCounter / interval);
+    m_emitCounter -= static_cast<float>(count) * interval;
+
+    m_elapsed += dt;
+    if (m_parameters.duration >= 0.f && m_elapsed > m_parameters.duration)
+    {
+        stop();
+    }
+    return count;
+}
+
+inline ParticlesSpawner::Particle ParticlesSpawner::spawn()
+{
+    const auto& p = m_parameters;
+    Particle result;
+
+    result.life = std::max(vary(p.particleLifeSpan), math::EPSILON);
+    const auto inverseLife = 1.f / result.life;
+
+    result.x = p.sourcePosition.variance.x * random();
+    result.y = p.sourcePosition.variance.y * random();
+
+    const auto startSize = std::max(vary(p.startSize), 0.f);
+    const auto endSize = p.endSize.value < 0.f ? startSize : std::max(vary(p.endSize), 0.f);
+    result.size = startSize;
+    result.sizeSpeed = (endSize - startSize) * inverseLife;
+
+    // rotationIsDir overrides the rotation after every step
+    const auto isGravity = p.emitterType == Parameters::EmitterType::GRAVITY;
+    const auto isRotationDir = isGravity && p.gravityParameters.rotationIsDir;
+    result.rotation = vary(p.startRotation);
+    result.rotationSpeed = isRotationDir ? 0.f : (vary(p.endRotation) - result.rotation) * inverseLife;
+
+    const float startColor[4] = {p.startColor.value.x + p.startColor.variance.x * random(),
+                                 p.startColor.value.y + p.startColor.variance.y * random(),
+                                 p.startColor.value.z + p.startColor.variance.z * random(),
+                                 p.startColor.value.w + p.startColor.variance.w * random()};
+    const float endColor[4] = {p.endColor.value.x + p.endColor.variance.x * random(),
+                               p.endColor.value.y + p.endColor.variance.y * random(),
+                               p.endColor.value.z + p.endColor.variance.z * random(),
+                               p.endColor.value.w + p.endColor.variance.w * random()};
+    for (size_t component = 0; component < 4; ++component)
+    {
+        const auto start = std::clamp(startColor[component], 0.f, 1.f);
+        const auto end = std::clamp(endColor[component], 0.f, 1.f);
+        result.color[component] = start;
+        result.colorSpeed[component] = (end - start) * inverseLife;
+    }
+
+    const auto angle = vary(p.angle);
+    if (isGravity)
+    {
+        const auto speed = vary(p.gravityParameters.startSpeed);
+        result.motion[0] = std::cos(angle) * speed;
+        result.motion[1] = std::sin(angle) * speed;
+        result.motion[2] = vary(p.gravityParameters.radialAcceleration);
+        result.motion[3] = vary(p.gravityParameters.tangentialAcceleration);
+    }
+    else
+    {
+        // from the max radius to the min one over the life
+        const auto startRadius = vary(p.radiusParameters.maxRadius);
+        const auto endRadius = vary(p.radiusParameters.minRadius);
+        result.motion[0] = angle;
+        result.motion[1] = vary(p.radiusParameters.rotatePerSecond);
+        result.motion[2] = startRadius;
+        result.motion[3] = (endRadius - startRadius) * inverseLife;
+        result.x = -std::cos(angle) * startRadius;
+        result.y = -std::sin(angle) * startRadius;
+    }
+    return result;
+}
+
+inline void ParticlesSpawner::setSeed(uint32_t seed)
+{
+    m_seed = seed != 0 ? seed : 0x9e3779b9u;
+}
+
+inline float ParticlesSpawner::random()
+{
+    // xorshift32
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return static_cast<float>(m_seed >> 8) * (2.f / 16777216.f) - 1.f;
+}
+
+inline float ParticlesSpawner::vary(const Parameters::Param<float>& param)
+{
+    return param.value + param.variance * random();
+}
+
+inline void ParticlesSimulation::setParameters(const Parameters& parameters)
+{
+    m_parameters = parameters;
+    m_spawner.setParameters(parameters);
+
+    // whole SIMD lanes, the tail is integrated along with the live particles and never read
+    m_capacity = (static_cast<size_t>(parameters.maxParticles) + 3) & ~static_cast<size_t>(3);
+    for (auto& data : m_channels)
+    {
+        data.resize(m_capacity, 0.f);
+    }
+    m_survivors.reserve(m_capacity);
+    m_size = std::min(m_size, static_cast<size_t>(parameters.maxParticles));
+}
+
+inline const ParticlesSimulation::Parameters& ParticlesSimulation::getParameters() const
+{
+    return m_parameters;
+}
+
+inline void ParticlesSimulation::start()
+{
+    m_spawner.start();
+}
+
+inline void ParticlesSimulation::stop()
+{
+    m_spawner.stop();
+}
+
+inline bool ParticlesSimulation::isEmitting() const
+{
+    return m_spawner.isEmitting();
+}
+
+inline void ParticlesSimulation::clear()
+{
+    m_size = 0;
+}
+
+inline void ParticlesSimulation::update(float dt, const math::mat4& world)
+{
+    m_world = world;
+
+    emit(m_spawner.advance(dt));
+
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    switch (m_parameters.emitterType)
+    {
+    case Parameters::EmitterType::GRAVITY:
+        integrateGravity(dt);
+        break;
+    case Parameters::EmitterType::RADIUS:
+        integrateRadius(dt);
+        break;
+    }
+    integrateCommon(dt);
+    compact();
+}
+
+inline size_t ParticlesSimulation::size() const
+{
+    return m_size;
+}
+
+inline size_t ParticlesSimulation::capacity() const
+{
+    return m_capacity;
+}
+
+inline bool ParticlesSimulation::hasActiveParticles() const
+{
+    return m_size > 0;
+}
+
+inline const float* ParticlesSimulation::getChannel(Channel channel) const
+{
+    return m_channels[channel].data();
+}
+
+template<typename VertexFormat>
+size_t ParticlesSimulation::writeVertices(VertexFormat* out, float depthStep) const
+{
+    return writeVertices(out, depthStep, static_cast<const float*>(nullptr));
+}
+
+template<typename VertexFormat>
+size_t ParticlesSimulation::writeVertices(VertexFormat* out, float depthStep, const math::mat4& world) const
+{
+    return writeVertices(out, depthStep, world.data);
+}
+
+template<typename VertexFormat>
+size_t ParticlesSimulation::writeVertices(VertexFormat* out, float depthStep, const float* world) const
+{
+    const auto* x = getChannel(X);
+    const auto* y = getChannel(Y);
+    const auto* originX = getChannel(OriginX);
+    const auto* originY = getChannel(OriginY);
+    const auto* originZ = getChannel(OriginZ);
+    const auto* size = getChannel(Size);
+    const auto* rotation = getChannel(Rotation);
+    const auto* red = getChannel(Red);
+    const auto* green = getChannel(Green);
+    const auto* blue = getChannel(Blue);
+    const auto* alpha = getChannel(Alpha);
+
+    const auto isWorld = m_parameters.transformMode == Parameters::TransformMode::PARTICLE;
+    const auto* m = m_world.data;
+    const auto source = m_parameters.sourcePosition.value;
+    const auto v0 = m_parameters.yCoordsFlipped ? 1.f : 0.f;
+    const auto v1 = 1.f - v0;
+
+    static constexpr float cornersU[VerticesPerParticle] = {-1.f, 1.f, 1.f, -1.f};
+    static constexpr float cornersV[VerticesPerParticle] = {-1.f, -1.f, 1.f, 1.f};
+    const math::vec2 uvs[VerticesPerParticle] = {{0.f, v0}, {1.f, v0}, {1.f, v1}, {0.f, v1}};
+
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        const auto half = size[i] * 0.5f;
+        const auto c = std::cos(rotation[i]) * half;
+        const auto s = std::sin(rotation[i]) * half;
+        const auto cx = source.x + x[i];
+        const auto cy = source.y + y[i];
+        const auto cz = depthStep * static_cast<float>(i);
+        const math::vec4 color = {std::clamp(red[i], 0.f, 1.f), std::clamp(green[i], 0.f, 1.f), std::clamp(blue[i], 0.f, 1.f), std::clamp(alpha[i], 0.f, 1.f)};
+
+        for (size_t corner = 0; corner < VerticesPerParticle; ++corner)
+        {
+            const auto px = cx + c * cornersU[corner] - s * cornersV[corner];
+            const auto py = cy + s * cornersU[corner] + c * cornersV[corner];
+            auto& vertex = *out++;
+            if (isWorld)
+            {
+                // current emitter orientation, birth position
+                vertex.w4_a_position = {m[0] * px + m[4] * py + m[8] * cz + originX[i],
+                                        m[1] * px + m[5] * py + m[9] * cz + originY[i],
+                                        m[2] * px + m[6] * py + m[10] * cz + originZ[i]};
+            }
+            else if (world)
+            {
+                vertex.w4_a_position = {world[0] * px + world[4] * py + world[8] * cz + world[12],
+                                        world[1] * px + world[5] * py + world[9] * cz + world[13],
+                                        world[2] * px + world[6] * py + world[10] * cz + world[14]};
+            }
+            else
+            {
+                vertex.w4_a_position = {px, py, cz};
+            }
+            vertex.w4_a_color = color;
+            vertex.w4_a_uv = uvs[corner];
+        }
+    }
+    return m_size * VerticesPerParticle;
+}
+
+template<typename Index>
+void ParticlesSimulation::writeIndices(Index* out, size_t particlesCount)
+{
+    for (size_t i = 0; i < particlesCount; ++i)
+    {
+        const auto base = static_cast<Index>(i * VerticesPerParticle);
+        *out++ = base;
+        *out++ = base + 1;
+        *out++ = base + 2;
+        *out++ = base;
+        *out++ = base + 2;
+        *out++ = base + 3;
+    }
+}
+
+inline void ParticlesSimulation::setSeed(uint32_t seed)
+{
+    m_spawner.setSeed(seed);
+}
+
+inline float* ParticlesSimulation::channel(Channel channel)
+{
+    return m_channels[channel].data();
+}
+
+inline void ParticlesSimulation::emit(size_t count)
+{
+    count = std::min(count, static_cast<size_t>(m_parameters.maxParticles) - m_size);
+    if (count == 0)
+    {
+        return;
+    }
+
+    const auto isGravity = m_parameters.emitterType == Parameters::EmitterType::GRAVITY;
+    const auto* world = m_world.data;
+    for (size_t i = m_size, end = m_size + count; i < end; ++i)
+    {
+        const auto particle = m_spawner.spawn();
+        channel(X)[i] = particle.x;
+        channel(Y)[i] = particle.y;
+        channel(OriginX)[i] = world[12];
+        channel(OriginY)[i] = world[13];
+        channel(OriginZ)[i] = world[14];
+        channel(Life)[i] = particle.life;
+        channel(Size)[i] = particle.size;
+        channel(SizeSpeed)[i] = particle.sizeSpeed;
+        channel(Rotation)[i] = particle.rotation;
+        channel(RotationSpeed)[i] = particle.rotationSpeed;
+        for (size_t component = 0; component < 4; ++component)
+        {
+            channel(static_cast<Channel>(Red + component))[i] = particle.color[component];
+            channel(static_cast<Channel>(RedSpeed + component))[i] = particle.colorSpeed[component];
+        }
+
+        const auto first = isGravity ? VelocityX : Angle;
+        for (size_t component = 0; component < 4; ++component)
+        {
+            channel(static_cast<Channel>(first + component))[i] = particle.motion[component];
+        }
+    }
+    m_size += count;
+}
+
+inline void ParticlesSimulation::integrateGravity(float dt)
+{
+    using namespace math::simd;
+
+    auto* x = channel(X);
+    auto* y = channel(Y);
+    auto* vx = channel(VelocityX);
+    auto* vy = channel(VelocityY);
+    const auto* radial = channel(RadialAcceleration);
+    const auto* tangential = channel(TangentialAcceleration);
+
+    const auto step = splat(dt);
+    const auto gravityX = splat(m_parameters.gravityParameters.gravity.x);
+    const auto gravityY = splat(m_parameters.gravityParameters.gravity.y);
+    const auto one = splat(1.f);
+    const auto minLength = splat(math::EPSILON);
+
+    for (size_t i = 0; i < m_size; i += 4)
+    {
+        const auto px = load(x + i);
+        const auto py = load(y + i);
+
+        // unit direction from the source, zero at the source itself
+        const auto inverseLength = div(one, max(sqrt(add(mul(px, px), mul(py, py))), minLength));
+        const auto rx = mul(px, inverseLength);
+        const auto ry = mul(py, inverseLength);
+        const auto ra = load(radial + i);
+        const auto ta = load(tangential + i);
+
+        // radial along (rx, ry), tangential along (-ry, rx)
+        const auto ax = add(sub(mul(rx, ra), mul(ry, ta)), gravityX);
+        const auto ay = add(add(mul(ry, ra), mul(rx, ta)), gravityY);
+
+        const auto nvx = madd(ax, step, load(vx + i));
+        const auto nvy = madd(ay, step, load(vy + i));
+        store(vx + i, nvx);
+        store(vy + i, nvy);
+        store(x + i, madd(nvx, step, px));
+        store(y + i, madd(nvy, step, py));
+    }
+
+    if (m_parameters.gravityParameters.rotationIsDir)
+    {
+        auto* rotation = channel(Rotation);
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            rotation[i] = std::atan2(vy[i], vx[i]);
+        }
+    }
+}
+
+inline void ParticlesSimulation::integrateRadius(float dt)
+{
+    auto* x = channel(X);
+    auto* y = channel(Y);
+    auto* angle = channel(Angle);
+    auto* radius = channel(Radius);
+    const auto* angleSpeed = channel(AngleSpeed);
+    const auto* radiusSpeed = channel(RadiusSpeed);
+
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        angle[i] += angleSpeed[i] * dt;
+        radius[i] += radiusSpeed[i] * dt;
+        x[i] = -std::cos(angle[i]) * radius[i];
+        y[i] = -std::sin(angle[i]) * radius[i];
+    }
+}
+
+inline void ParticlesSimulation::integrateCommon(float dt)
+{
+    using namespace math::simd;
+
+    const auto step = splat(dt);
+    const auto zero = splat(0.f);
+
+    auto* life = channel(Life);
+    for (size_t i = 0; i < m_size; i += 4)
+    {
+        store(life + i, sub(load(life + i), step));
+    }
+
+    auto* size = channel(Size);
+    const auto* sizeSpeed = channel(SizeSpeed);
+    for (size_t i = 0; i < m_size; i += 4)
+    {
+        store(size + i, max(madd(load(sizeSpeed + i), step, load(size + i)), zero));
+    }
+
+    // rotation and the color components go the same way, each along its speed channel
+    static constexpr std::pair<Channel, Channel> linear[] = {{Rotation, RotationSpeed}, {Red, RedSpeed}, {Green, GreenSpeed}, {Blue, BlueSpeed}, {Alpha, AlphaSpeed}};
+    for (const auto& [valueChannel, speedChannel] : linear)
+    {
+        auto* value = channel(valueChannel);
+        const auto* speed = channel(speedChannel);
+        for (size_t i = 0; i < m_size; i += 4)
+        {
+            store(value + i, madd(load(speed + i), step, load(value + i)));
+        }
+    }
+}
+
+inline void ParticlesSimulation::compact()
+{
+    const auto* life = channel(Life);
+    m_survivors.clear();
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        if (life[i] > 0.f)
+        {
+            m_survivors.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (m_survivors.size() == m_size)
+    {
+        return;
+    }
+
+    // survivors[j] >= j, so moving forward in place never overwrites a pending particle
+    const auto count = m_survivors.size();
+    for (auto& data : m_channels)
+    {
+        auto* values = data.data();
+        for (size_t j = 0; j < count; ++j)
+        {
+            values[j] = values[m_survivors[j]];
+        }
+    }
+    m_size = count;
+}
+
+inline bool ParticlesGpuStream::isSupported(const Parameters& parameters)
+{
+    if (parameters.emitterType == Parameters::EmitterType::RADIUS)
+    {
+        return true;
+    }
+    // radial and tangential accelerations depend on the position, they have no closed form in the age
+    const auto& gravity = parameters.gravityParameters;
+    return gravity.radialAcceleration.value == 0.f && gravity.radialAcceleration.variance == 0.f
+        && gravity.tangentialAcceleration.value == 0.f && gravity.tangentialAcceleration.variance == 0.f;
+}
+
+inline const char* ParticlesGpuStream::getShaderSource()
+{
+    return R"(
+attribute vec4 w4_a_spawn;
+attribute vec3 w4_a_origin;
+attribute vec2 w4_a_start;
+attribute vec4 w4_a_motion;
+attribute vec4 w4_a_sizeRotation;
+attribute vec4 w4_a_color;
+attribute vec4 w4_a_colorSpeed;
+
+uniform vec2 w4_u_particlesGravity;
+uniform vec2 w4_u_particlesSource;
+uniform vec4 w4_u_particlesFlags;
+uniform float w4_u_particlesDepthStep;
+
+// false for dead and unborn particles, the vertex is to be put out of the clip volume
+bool w4_evaluateParticle(out vec3 position, out vec4 color, out vec2 uv)
+{
+    float age = w4_u_time - w4_a_spawn.x;
+    if (age < 0.0 || age >= w4_a_spawn.y)
+    {
+        position = vec3(0.0);
+        color = vec4(0.0);
+        uv = vec2(0.0);
+        return false;
+    }
+
+    vec2 local;
+    float rotation = w4_a_sizeRotation.z + w4_a_sizeRotation.w * age;
+    if (w4_u_particlesFlags.x < 0.5)
+    {
+        local = w4_a_start + (w4_a_motion.xy + 0.5 * w4_u_particlesGravity * age) * age;
+        if (w4_u_particlesFlags.y > 0.5)
+        {
+            vec2 velocity = w4_a_motion.xy + w4_u_particlesGravity * age;
+            rotation = atan(velocity.y, velocity.x);
+        }
+    }
+    else
+    {
+        float angle = w4_a_motion.x + w4_a_motion.y * age;
+        float radius = w4_a_motion.z + w4_a_motion.w * age;
+        local = -vec2(cos(angle), sin(angle)) * radius;
+    }
+
+    float corner = w4_a_spawn.w;
+    vec2 cornerUv = vec2(step(0.5, corner) * step(corner, 2.5), step(1.5, corner));
+    float halfSize = max(w4_a_sizeRotation.x + w4_a_sizeRotation.y * age, 0.0) * 0.5;
+    vec2 offset = (cornerUv * 2.0 - 1.0) * halfSize;
+    float c = cos(rotation);
+    float s = sin(rotation);
+    vec3 p = vec3(w4_u_particlesSource + local + vec2(c * offset.x - s * offset.y, s * offset.x + c * offset.y),
+                  w4_a_spawn.z * w4_u_particlesDepthStep);
+
+    if (w4_u_particlesFlags.z > 0.5)
+    {
+        position = mat3(w4_u_model) * p + w4_a_origin;
+    }
+    else
+    {
+        position = (w4_u_model * vec4(p, 1.0)).xyz;
+    }
+    color = clamp(w4_a_color + w4_a_colorSpeed * age, 0.0, 1.0);
+    uv = vec2(cornerUv.x, w4_u_particlesFlags.w > 0.5 ? 1.0 - cornerUv.y : cornerUv.y);
+    return true;
+}
+)";
+}
+
+inline void ParticlesGpuStream::setParameters(const Parameters& parameters)
+{
+    W4_ASSERT(isSupported(parameters));
+    m_parameters = parameters;
+    m_spawner.setParameters(parameters);
+
+    const auto capacity = static_cast<size_t>(parameters.maxParticles);
+    if (capacity != m_deathTimes.size())
+    {
+        m_vertices.assign(capacity * ParticlesSimulation::VerticesPerParticle, VertexFormat());
+        m_deathTimes.assign(capacity, std::numeric_limits<float>::lowest());
+        m_head = 0;
+        m_lastDeathTime = 0.f;
+        markDirty(0, m_vertices.size());
+    }
+}
+
+inline const ParticlesGpuStream::Parameters& ParticlesGpuStream::getParameters() const
+{
+    return m_parameters;
+}
+
+inline void ParticlesGpuStream::start()
+{
+    m_spawner.start();
+}
+
+inline void ParticlesGpuStream::stop()
+{
+    m_spawner.stop();
+}
+
+inline bool ParticlesGpuStream::isEmitting() const
+{
+    return m_spawner.isEmitting();
+}
+
+inline void ParticlesGpuStream::clear()
+{
+    // zero life, the shader drops them
+    std::fill(m_vertices.begin(), m_vertices.end(), VertexFormat());
+    std::fill(m_deathTimes.begin(), m_deathTimes.end(), std::numeric_limits<float>::lowest());
+    m_head = 0;
+    m_lastDeathTime = 0.f;
+    markDirty(0, m_vertices.size());
+}
+
+inline void ParticlesGpuStream::update(float dt, float time, const math::mat4& world)
+{
+    m_spawnedCount = 0;
+    const auto count = m_spawner.advance(dt);
+    const auto capacity = m_deathTimes.size();
+    if (count == 0 || capacity == 0)
+    {
+        return;
+    }
+
+    const auto* m = world.data;
+    const math::vec3 origin = {m[12], m[13], m[14]};
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto slot = m_head;
+        if (m_deathTimes[slot] > time)
+        {
+            // the oldest particle is still alive, the pool is full
+            break;
+        }
+
+        const auto particle = m_spawner.spawn();
+        const auto deathTime = time + particle.life;
+        m_deathTimes[slot] = deathTime;
+        m_lastDeathTime = std::max(m_lastDeathTime, deathTime);
+
+        const auto first = slot * ParticlesSimulation::VerticesPerParticle;
+        for (size_t corner = 0; corner < ParticlesSimulation::VerticesPerParticle; ++corner)
+        {
+            auto& vertex = m_vertices[first + corner];
+            vertex.w4_a_spawn = {time, particle.life, static_cast<float>(slot), static_cast<float>(corner)};
+            vertex.w4_a_origin = origin;
+            vertex.w4_a_start = {particle.x, particle.y};
+            vertex.w4_a_motion = {particle.motion[0], particle.motion[1], particle.motion[2], particle.motion[3]};
+            vertex.w4_a_sizeRotation = {particle.size, particle.sizeSpeed, particle.rotation, particle.rotationSpeed};
+            vertex.w4_a_color = {particle.color[0], particle.color[1], particle.color[2], particle.color[3]};
+            vertex.w4_a_colorSpeed = {particle.colorSpeed[0], particle.colorSpeed[1], particle.colorSpeed[2], particle.colorSpeed[3]};
+        }
+        markDirty(first, first + ParticlesSimulation::VerticesPerParticle);
+
+        m_head = (m_head + 1) % capacity;
+        ++m_spawnedCount;
+    }
+}
+
+inline size_t ParticlesGpuStream::capacity() const
+{
+    return m_deathTimes.size();
+}
+
+inline bool ParticlesGpuStream::hasActiveParticles(float time) const
+{
+    return m_lastDeathTime > time;
+}
+
+inline size_t ParticlesGpuStream::getSpawnedCount() const
+{
+    return m_spawnedCount;
+}
+
+inline const ParticlesGpuStream::VertexFormat* ParticlesGpuStream::getVertices() const
+{
+    return m_vertices.data();
+}
+
+inline size_t ParticlesGpuStream::getVerticesCount() const
+{
+    return m_vertices.size();
+}
+
+inline bool ParticlesGpuStream::isDirty() const
+{
+    return m_dirtyFirst < m_dirtyLast;
+}
+
+inline std::pair<size_t, size_t> ParticlesGpuStream::getDirtyVertices() const
+{
+    return {m_dirtyFirst, m_dirtyLast};
+}
+
+inline void ParticlesGpuStream::clearDirty()
+{
+    m_dirtyFirst = m_dirtyLast = 0;
+}
+
+inline math::vec4 ParticlesGpuStream::getShaderFlags() const
+{
+    const auto isRadius = m_parameters.emitterType == Parameters::EmitterType::RADIUS;
+    const auto isRotationDir = !isRadius && m_parameters.gravityParameters.rotationIsDir;
+    const auto isWorld = m_parameters.transformMode == Parameters::TransformMode::PARTICLE;
+    return {isRadius ? 1.f : 0.f, isRotationDir ? 1.f : 0.f, isWorld ? 1.f : 0.f, m_parameters.yCoordsFlipped ? 1.f : 0.f};
+}
+
+inline void ParticlesGpuStream::setSeed(uint32_t seed)
+{
+    m_spawner.setSeed(seed);
+}
+
+inline void ParticlesGpuStream::markDirty(size_t first, size_t last)
+{
+    if (!isDirty())
+    {
+        m_dirtyFirst = first;
+        m_dirtyLast = last;
+        return;
+    }
+    m_dirtyFirst = std::min(m_dirtyFirst, first);
+    m_dirtyLast = std::max(m_dirtyLast, last);
+}
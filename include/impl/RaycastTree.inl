@@ -0,0 +1,117 @@
+inline RaycastTree::RaycastTree(float margin)
+    : m_tree(margin)
+{
+}
+
+inline void RaycastTree::add(Collider* collider)
+{
+    W4_ASSERT(m_proxies.find(collider) == m_proxies.end());
+    m_proxies.emplace(collider, m_tree.insert(getWorldBounds(*collider), collider));
+}
+
+inline void RaycastTree::remove(Collider* collider)
+{
+    auto it = m_proxies.find(collider);
+    if (it == m_proxies.end())
+    {
+        return;
+    }
+    m_tree.remove(it->second);
+    m_proxies.erase(it);
+}
+
+inline void RaycastTree::update(Collider* collider)
+{
+    auto it = m_proxies.find(collider);
+    W4_ASSERT(it != m_proxies.end());
+    m_tree.move(it->second, getWorldBounds(*collider));
+}
+
+inline void RaycastTree::clear()
+{
+    m_tree.clear();
+    m_proxies.clear();
+}
+
+inline size_t RaycastTree::size() const
+{
+    return m_proxies.size();
+}
+
+inline CollisionInfo RaycastTree::raycast(const math::Ray& ray) const
+{
+    CollisionInfo result;
+    raycast(&ray, &result, 1);
+    return result;
+}
+
+inline std::vector<CollisionInfo> RaycastTree::raycast(const std::vector<math::Ray>& rays) const
+{
+    std::vector<CollisionInfo> results(rays.size());
+    raycast(rays.data(), results.data(), rays.size());
+    return results;
+}
+
+inline void RaycastTree::raycast(const math::Ray* rays, CollisionInfo* results, size_t count) const
+{
+    constexpr auto maxDistance = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& ray = rays[i];
+        auto& best = results[i];
+        best = {};
+        m_tree.raycast(ray, maxDistance, [&ray, &best](AABBTree<Collider*>::ProxyId, Collider* collider, float)
+        {
+            CollisionInfo info;
+            if (collider->isEnabled() && collider->intersect(ray, info) && info.distance < best.distance)
+            {
+                info.target = collider;
+                best = info;
+            }
+            return maxDistance;
+        });
+    }
+}
+
+inline Bounds RaycastTree::getWorldBounds(const Collider& collider)
+{
+    const auto& volume = collider.getVolume();
+    const auto& transform = volume->getTransform();
+
+    std::array<math::vec3, 8> points;
+    if (volume->is<AABB>())
+    {
+        points = volume->as<AABB>()->getBoundsRaw().getPoints(transform);
+    }
+    else if (volume->is<OBB>())
+    {
+        points = volume->as<OBB>()->getPoints();
+    }
+    else if (volume->is<Frustum>())
+    {
+        points = volume->as<Frustum>()->getFrustumRaw().points;
+        math::transformPoints(transform.getMatrix(), points.data(), points.data(), points.size());
+    }
+    else if (volume->is<Sphere>())
+    {
+        const auto& scale = transform.scale();
+        const float radius = volume->as<Sphere>()->getRadiusRaw() * std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)});
+        const auto& center = transform.translation();
+        return {center - math::vec3(radius, radius, radius), center + math::vec3(radius, radius, radius)};
+    }
+    else
+    {
+        FATAL_ERROR("RaycastTree: unsupported bounding volume '[%s]'", volume->getTypeInfo().name());
+    }
+
+    Bounds bounds(points[0], points[0]);
+    for (const auto& point: points)
+    {
+        for (unsigned axis = 0; axis < 3; ++axis)
+        {
+            bounds.min()[axis] = std::min(bounds.min()[axis], point[axis]);
+            bounds.max()[axis] = std::max(bounds.max()[axis], point[axis]);
+        }
+    }
+    return bounds;
+}
@@ -0,0 +1,410 @@
+inline void LocalPose::resize(size_t bonesCount)
+{
+    translations.resize(bonesCount);
+    rotations.resize(bonesCount);
+    scales.resize(bonesCount);
+}
+
+inline size_t LocalPose::size() const
+{
+    return translations.size();
+}
+
+inline void LocalPose::set(size_t bone, const math::Transform& transform)
+{
+    translations[bone] = transform.translation();
+    rotations[bone] = transform.rotation().quaternion;
+    scales[bone] = transform.scale();
+}
+
+inline void samplePose(const SkinnedAnimation& animation, float time, LocalPose& pose)
+{
+    const auto count = animation.getBoneNames().size();
+    pose.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        pose.set(i, animation.getTransform(static_cast<BoneIndex>(i), time).decompose());
+    }
+}
+
+inline void samplePose(const SimpleSkinnedAnimation& animation, float time, LocalPose& pose)
+{
+    const auto count = animation.getBonesCount();
+    pose.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto bone = static_cast<BoneIndex>(i);
+        pose.translations[i] = animation.getTranslationTrack(bone)->sample(time);
+        pose.rotations[i] = animation.getRotationTrack(bone)->sample(time).quaternion;
+        pose.scales[i] = animation.getScaleTrack(bone)->sample(time);
+    }
+}
+
+inline void PoseBlender::begin(size_t bonesCount)
+{
+    m_sum.resize(bonesCount);
+    m_weights.assign(bonesCount, 0.f);
+    for (size_t i = 0; i < bonesCount; ++i)
+    {
+        m_sum.translations[i] = {0.f, 0.f, 0.f};
+        m_sum.rotations[i].set(0.f, 0.f, 0.f, 0.f);
+        m_sum.scales[i] = {0.f, 0.f, 0.f};
+    }
+}
+
+inline void PoseBlender::add(const LocalPose& pose, const Mapping& mapping, float weight, const float* boneWeights)
+{
+    if (weight <= 0.f)
+    {
+        return;
+    }
+    for (const auto& [from, to]: mapping)
+    {
+        const auto w = boneWeights ? weight * boneWeights[from] : weight;
+        if (w > 0.f)
+        {
+            accumulate(to, pose.translations[from], pose.rotations[from], pose.scales[from], w);
+        }
+    }
+}
+
+inline void PoseBlender::finish(const LocalPose& bindPose, LocalPose& out) const
+{
+    const auto count = m_weights.size();
+    W4_ASSERT(bindPose.size() == count);
+    out.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto weight = m_weights[i];
+        auto translation = m_sum.translations[i];
+        auto rotation = m_sum.rotations[i];
+        auto scale = m_sum.scales[i];
+
+        if (weight < 1.f)
+        {
+            const auto rest = 1.f - weight;
+            const auto& bind = bindPose.rotations[i];
+            const auto sign = (rotation.x * bind.x + rotation.y * bind.y + rotation.z * bind.z + rotation.w * bind.w) < 0.f ? -rest : rest;
+            translation.x += bindPose.translations[i].x * rest;
+            translation.y += bindPose.translations[i].y * rest;
+            translation.z += bindPose.translations[i].z * rest;
+            rotation.x += bind.x * sign;
+            rotation.y += bind.y * sign;
+            rotation.z += bind.z * sign;
+            rotation.w += bind.w * sign;
+            scale.x += bindPose.scales[i].x * rest;
+            scale.y += bindPose.scales[i].y * rest;
+            scale.z += bindPose.scales[i].z * rest;
+            weight = 1.f;
+        }
+
+        const auto inv = 1.f / weight;
+        out.translations[i] = {translation.x * inv, translation.y * inv, translation.z * inv};
+        out.scales[i] = {scale.x * inv, scale.y * inv, scale.z * inv};
+
+        const auto length = std::sqrt(rotation.x * rotation.x + rotation.y * rotation.y + rotation.z * rotation.z + rotation.w * rotation.w);
+        if (length > math::EPSILON)
+        {
+            const auto invLength = 1.f / length;
+            out.rotations[i].set(rotation.x * invLength, rotation.y * invLength, rotation.z * invLength, rotation.w * invLength);
+        }
+        else
+        {
+            out.rotations[i] = bindPose.rotations[i];
+        }
+    }
+}
+
+inline void PoseBlender::accumulate(BoneIndex bone, const math::vec3& translation, const math::Quaternion& rotation, const math::vec3& scale, float weight)
+{
+    auto& t = m_sum.translations[bone];
+    auto& q = m_sum.rotations[bone];
+    auto& s = m_sum.scales[bone];
+
+    t.x += translation.x * weight;
+    t.y += translation.y * weight;
+    t.z += translation.z * weight;
+
+    // q and -q are the same rotation, keep all contributions in one hemisphere
+    const auto sign = (q.x * rotation.x + q.y * rotation.y + q.z * rotation.z + q.w * rotation.w) < 0.f ? -weight : weight;
+    q.x += rotation.x * sign;
+    q.y += rotation.y * sign;
+    q.z += rotation.z * sign;
+    q.w += rotation.w * sign;
+
+    s.x += scale.x * weight;
+    s.y += scale.y * weight;
+    s.z += scale.z * weight;
+
+    m_weights[bone] += weight;
+}
+
+inline void SkeletonPose::setHierarchy(const std::vector<int32_t>& parents)
+{
+    const auto count = parents.size();
+    m_parents = parents;
+    m_locals.resize(count);
+    m_worlds.resize(count);
+    m_hasLocals = false;
+
+    // depth of every bone, then a stable counting sort: parents come before their children
+    std::vector<uint32_t> depths(count, std::numeric_limits<uint32_t>::max());
+    uint32_t maxDepth = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t depth = 0;
+        for (auto parent = m_parents[i]; parent != NoParent; parent = m_parents[parent])
+        {
+            W4_ASSERT(parent >= 0 && static_cast<size_t>(parent) < count && depth < count);
+            ++depth;
+        }
+        depths[i] = depth;
+        maxDepth = std::max(maxDepth, depth);
+    }
+    std::vector<uint32_t> offsets(maxDepth + 2, 0);
+    for (auto depth: depths)
+    {
+        ++offsets[depth + 1];
+    }
+    for (size_t d = 1; d < offsets.size(); ++d)
+    {
+        offsets[d] += offsets[d - 1];
+    }
+    m_order.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_order[offsets[depths[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+inline void SkeletonPose::setInverseBindMatrices(std::vector<math::mat4> matrices)
+{
+    W4_ASSERT(matrices.empty() || matrices.size() == m_parents.size());
+    m_inverseBind = std::move(matrices);
+    m_skin.resize(m_inverseBind.size());
+}
+
+inline void SkeletonPose::evaluate(const LocalPose& pose, const math::mat4& root, size_t bonesLimit)
+{
+    const auto count = m_parents.size();
+    W4_ASSERT(pose.size() == count);
+
+    // the first evaluation takes every bone, capped bones need some local matrix to keep
+    if (bonesLimit >= count || !m_hasLocals)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            composeMatrix(pose.translations[i], pose.rotations[i], pose.scales[i], m_locals[i]);
+        }
+        m_hasLocals = true;
+    }
+    else
+    {
+        for (size_t i = 0; i < bonesLimit; ++i)
+        {
+            const auto bone = m_order[i];
+            composeMatrix(pose.translations[bone], pose.rotations[bone], pose.scales[bone], m_locals[bone]);
+        }
+    }
+
+    for (auto bone: m_order)
+    {
+        const auto parent = m_parents[bone];
+        const auto& parentWorld = parent == NoParent ? root : m_worlds[parent];
+        math::simd::mulMat4(parentWorld.data, m_locals[bone].data, m_worlds[bone].data);
+    }
+
+    if (!m_inverseBind.empty())
+    {
+        math::multiply(m_worlds.data(), m_inverseBind.data(), m_skin.data(), count);
+    }
+}
+
+inline size_t SkeletonPose::size() const
+{
+    return m_parents.size();
+}
+
+inline const std::vector<math::mat4>& SkeletonPose::getLocalMatrices() const
+{
+    return m_locals;
+}
+
+inline const std::vector<math::mat4>& SkeletonPose::getWorldMatrices() const
+{
+    return m_worlds;
+}
+
+inline const std::vector<math::mat4>& SkeletonPose::getSkinMatrices() const
+{
+    return m_skin;
+}
+
+inline void SkeletonPose::composeMatrix(const math::vec3& translation, const math::Quaternion& rotation, const math::vec3& scale, math::mat4& out)
+{
+    const auto x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+    const auto xx = x * x, yy = y * y, zz = z * z;
+    const auto xy = x * y, xz = x * z, yz = y * z;
+    const auto wx = w * x, wy = w * y, wz = w * z;
+
+    auto* m = out.data;
+    m[0]  = (1.f - 2.f * (yy + zz)) * scale.x;
+    m[1]  = 2.f * (xy + wz) * scale.x;
+    m[2]  = 2.f * (xz - wy) * scale.x;
+    m[3]  = 0.f;
+    m[4]  = 2.f * (xy - wz) * scale.y;
+    m[5]  = (1.f - 2.f * (xx + zz)) * scale.y;
+    m[6]  = 2.f * (yz + wx) * scale.y;
+    m[7]  = 0.f;
+    m[8]  = 2.f * (xz + wy) * scale.z;
+    m[9]  = 2.f * (yz - wx) * scale.z;
+    m[10] = (1.f - 2.f * (xx + yy)) * scale.z;
+    m[11] = 0.f;
+    m[12] = translation.x;
+    m[13] = translation.y;
+    m[14] = translation.z;
+    m[15] = 1.f;
+}
+
+#if defined(__EMSCRIPTEN__)
+
+inline void PoseWorkers::run(size_t count, const Job& job)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        job(i);
+    }
+}
+
+inline void PoseWorkers::setThreadsCount(size_t)
+{
+}
+
+inline size_t PoseWorkers::getThreadsCount()
+{
+    return 0;
+}
+
+inline size_t PoseWorkers::getDefaultThreadsCount()
+{
+    return 0;
+}
+
+#else
+
+inline void PoseWorkers::run(size_t count, const Job& job)
+{
+    auto& pool = getPool();
+    if (pool.threads.empty() || count < 2)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(pool.mutex);
+        pool.job = &job;
+        pool.count = count;
+        pool.next = 0;
+        pool.pending = pool.threads.size();
+        ++pool.generation;
+    }
+    pool.wake.notify_all();
+    pool.drain();
+
+    // every worker has to leave the job before it goes out of scope
+    std::unique_lock lock(pool.mutex);
+    pool.done.wait(lock, [&pool] { return pool.pending == 0; });
+    pool.job = nullptr;
+}
+
+inline void PoseWorkers::setThreadsCount(size_t count)
+{
+    auto& pool = getPool();
+    pool.stop();
+    pool.start(count);
+}
+
+inline size_t PoseWorkers::getThreadsCount()
+{
+    return getPool().threads.size();
+}
+
+inline size_t PoseWorkers::getDefaultThreadsCount()
+{
+    const auto hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+inline PoseWorkers::Pool& PoseWorkers::getPool()
+{
+    static Pool pool;
+    return pool;
+}
+
+inline PoseWorkers::Pool::~Pool()
+{
+    stop();
+}
+
+inline void PoseWorkers::Pool::start(size_t threadsCount)
+{
+    // workers start from the current generation, a run() issued before they are scheduled is not missed
+    isStopping = false;
+    threads.reserve(threadsCount);
+    for (size_t i = 0; i < threadsCount; ++i)
+    {
+        threads.emplace_back([this, seen = generation] { work(seen); });
+    }
+}
+
+inline void PoseWorkers::Pool::stop()
+{
+    {
+        std::lock_guard lock(mutex);
+        isStopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+}
+
+inline void PoseWorkers::Pool::work(uint64_t seen)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this, seen] { return isStopping || generation != seen; });
+            if (isStopping)
+            {
+                return;
+            }
+            seen = generation;
+        }
+
+        drain();
+
+        std::lock_guard lock(mutex);
+        if (--pending == 0)
+        {
+            done.notify_one();
+        }
+    }
+}
+
+inline void PoseWorkers::Pool::drain()
+{
+    for (auto i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+    {
+        (*job)(i);
+    }
+}
+
+#endif
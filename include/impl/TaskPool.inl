@@ -83,3 +83,241 @@ bool TaskPool<void (Args...)>::isEmpty() const
     }
     return m_addedTasks.empty();
 }
+
+inline TimerWheel::TimerWheel(float tickDuration)
+    : m_tickDuration(tickDuration)
+{
+    W4_ASSERT(tickDuration > 0.f);
+    m_slots.fill(Null);
+}
+
+inline TimerWheel::Handle TimerWheel::add(float period, const Callable& callable, bool isLooped)
+{
+    const auto ticks = std::ceil(static_cast<double>(std::max(period, 0.f)) / m_tickDuration);
+    if (!(ticks < static_cast<double>(MaxTicks)))
+    {
+        // the top level would wrap around and fire it early
+        FATAL_ERROR("TimerWheel: period %f s is past the %llu ticks of the wheel", period, static_cast<unsigned long long>(MaxTicks - 1));
+    }
+
+    uint32_t index;
+    if (!m_free.empty())
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        if (m_timers.size() > IndexMask)
+        {
+            FATAL_ERROR("TimerWheel: more than %u timers", IndexMask + 1);
+        }
+        index = static_cast<uint32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+
+    auto& timer = m_timers[index];
+    timer.func = callable;
+    timer.period = std::max<uint64_t>(1, static_cast<uint64_t>(ticks));
+    timer.expiry = m_tick + timer.period;
+    timer.isLooped = isLooped;
+    timer.isActive = true;
+    ++m_size;
+    schedule(index);
+    return makeHandle(index);
+}
+
+inline bool TimerWheel::remove(Handle handle)
+{
+    const auto index = findIndex(handle);
+    if (index == Null)
+    {
+        return false;
+    }
+    if (index == m_firing)
+    {
+        // released once its callback returns
+        m_timers[index].isActive = false;
+        return true;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+inline bool TimerWheel::isActive(Handle handle) const
+{
+    return findIndex(handle) != Null;
+}
+
+inline size_t TimerWheel::advance(float dt)
+{
+    m_pendingTicks += static_cast<double>(dt) / m_tickDuration;
+    auto ticks = static_cast<uint64_t>(m_pendingTicks);
+    m_pendingTicks -= static_cast<double>(ticks);
+
+    size_t fired = 0;
+    while (ticks > 0)
+    {
+        // a run of empty level 0 slots is crossed at once, up to the next cascade at the latest
+        const auto boundary = (m_tick | (SlotsPerLevel - 1)) + 1;
+        const auto last = std::min(boundary, m_tick + ticks);
+        auto next = m_tick + 1;
+        while (next < last && m_slots[next & (SlotsPerLevel - 1)] == Null)
+        {
+            ++next;
+        }
+        ticks -= next - m_tick;
+        m_tick = next;
+
+        for (size_t level = Levels - 1; level > 0; --level)
+        {
+            if ((m_tick & ((uint64_t(1) << (SlotBits * level)) - 1)) == 0)
+            {
+                cascade(level);
+            }
+        }
+
+        auto& head = m_slots[m_tick & (SlotsPerLevel - 1)];
+        while (head != Null)
+        {
+            const auto index = head;
+            unlink(index);
+
+            // moved out, the callback may add timers and grow m_timers
+            auto func = std::move(m_timers[index].func);
+            m_firing = index;
+            const bool keep = func();
+            m_firing = Null;
+            ++fired;
+
+            auto& timer = m_timers[index];
+            if (timer.isActive && timer.isLooped && keep)
+            {
+                timer.func = std::move(func);
+                timer.expiry += timer.period;
+                schedule(index);
+            }
+            else
+            {
+                release(index);
+            }
+        }
+    }
+    return fired;
+}
+
+inline void TimerWheel::reset()
+{
+    for (uint32_t index = 0; index < m_timers.size(); ++index)
+    {
+        if (m_timers[index].isActive)
+        {
+            if (index == m_firing)
+            {
+                m_timers[index].isActive = false;
+                continue;
+            }
+            unlink(index);
+            release(index);
+        }
+    }
+}
+
+inline bool TimerWheel::isEmpty() const
+{
+    return m_size == 0;
+}
+
+inline size_t TimerWheel::size() const
+{
+    return m_size;
+}
+
+inline TimerWheel::Handle TimerWheel::makeHandle(uint32_t index) const
+{
+    return (m_timers[index].generation << IndexBits) | index;
+}
+
+inline uint32_t TimerWheel::findIndex(Handle handle) const
+{
+    const auto index = handle & IndexMask;
+    if (handle == InvalidHandle || index >= m_timers.size())
+    {
+        return Null;
+    }
+    const auto& timer = m_timers[index];
+    return timer.isActive && timer.generation == (handle >> IndexBits) ? index : Null;
+}
+
+inline void TimerWheel::schedule(uint32_t index)
+{
+    const auto expiry = m_timers[index].expiry;
+    const auto delta = expiry > m_tick ? expiry - m_tick : 0;
+    W4_ASSERT(delta < MaxTicks);
+    size_t level = 0;
+    while (level + 1 < Levels && delta >> (SlotBits * (level + 1)))
+    {
+        ++level;
+    }
+    link(index, static_cast<uint32_t>(level * SlotsPerLevel + ((expiry >> (SlotBits * level)) & (SlotsPerLevel - 1))));
+}
+
+inline void TimerWheel::link(uint32_t index, uint32_t slot)
+{
+    auto& timer = m_timers[index];
+    timer.slot = slot;
+    timer.prev = Null;
+    timer.next = m_slots[slot];
+    if (timer.next != Null)
+    {
+        m_timers[timer.next].prev = index;
+    }
+    m_slots[slot] = index;
+}
+
+inline void TimerWheel::unlink(uint32_t index)
+{
+    auto& timer = m_timers[index];
+    if (timer.slot == Null)
+    {
+        return;
+    }
+    if (timer.prev != Null)
+    {
+        m_timers[timer.prev].next = timer.next;
+    }
+    else
+    {
+        m_slots[timer.slot] = timer.next;
+    }
+    if (timer.next != Null)
+    {
+        m_timers[timer.next].prev = timer.prev;
+    }
+    timer.prev = timer.next = timer.slot = Null;
+}
+
+inline void TimerWheel::release(uint32_t index)
+{
+    auto& timer = m_timers[index];
+    timer.func = nullptr;
+    timer.isActive = false;
+    timer.generation = timer.generation == MaxGeneration ? 1 : timer.generation + 1;
+    m_free.push_back(index);
+    --m_size;
+}
+
+inline void TimerWheel::cascade(size_t level)
+{
+    const auto slot = level * SlotsPerLevel + ((m_tick >> (SlotBits * level)) & (SlotsPerLevel - 1));
+    auto index = m_slots[slot];
+    m_slots[slot] = Null;
+    while (index != Null)
+    {
+        const auto next = m_timers[index].next;
+        m_timers[index].slot = Null;
+        schedule(index);
+        index = next;
+    }
+}
@@ -3,6 +3,88 @@
 
 namespace w4::resources {
 
+template<typename GetTime>
+void TrackSeekIndex::build(size_t count, GetTime&& getTime)
+{
+    clear();
+    if (count < 2)
+    {
+        return;
+    }
+    const auto startTime = getTime(0);
+    const auto span = getTime(count - 1) - startTime;
+    if (!(span > 0.f))
+    {
+        return;
+    }
+
+    const auto buckets = count;
+    m_startTime = startTime;
+    m_bucketsPerSecond = static_cast<float>(buckets) / span;
+    m_firstKeys.resize(buckets + 1);
+
+    // a bucket starts at the first key that falls in it or in a later one, so a lookup only looks between two bounds
+    size_t key = 0;
+    for (size_t bucket = 0; bucket <= buckets; ++bucket)
+    {
+        while (key < count && getBucket(getTime(key)) < bucket)
+        {
+            ++key;
+        }
+        m_firstKeys[bucket] = static_cast<uint32_t>(key);
+    }
+}
+
+inline void TrackSeekIndex::clear()
+{
+    m_firstKeys.clear();
+    m_startTime = 0.f;
+    m_bucketsPerSecond = 0.f;
+}
+
+inline bool TrackSeekIndex::isBuilt() const
+{
+    return !m_firstKeys.empty();
+}
+
+template<typename GetTime>
+size_t TrackSeekIndex::upperBound(float time, GetTime&& getTime) const
+{
+    W4_ASSERT(isBuilt());
+    const auto bucket = getBucket(time);
+    size_t first = m_firstKeys[bucket];
+    size_t last = m_firstKeys[bucket + 1];
+    while (first < last)
+    {
+        const auto middle = first + (last - first) / 2;
+        if (getTime(middle) <= time)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+inline size_t TrackSeekIndex::getMemorySize() const
+{
+    return m_firstKeys.capacity() * sizeof(uint32_t);
+}
+
+inline size_t TrackSeekIndex::getBucket(float time) const
+{
+    const auto lastBucket = m_firstKeys.size() - 2;
+    const auto position = (time - m_startTime) * m_bucketsPerSecond;
+    if (!(position > 0.f))
+    {
+        return 0;
+    }
+    return position >= static_cast<float>(lastBucket) ? lastBucket : static_cast<size_t>(position);
+}
+
 //template<typename T>
 //Track<T>::Track(const ResourceLoadDescr& descr)
 //    : w4::resources::Resource(descr.getName(), descr)
@@ -36,39 +118,42 @@ void Track<T>::Accessor::invalidate()
 template<typename T>
 void Track<T>::Accessor::updateTime(float time)
 {
-    const auto& values = m_track->getValues();
-    if (values.empty())
+    const auto count = m_track->getValuesCount();
+    if (count == 0)
     {
         return;
     }
+    if (count == 1)
+    {
+        m_currentValueIndex = m_nextValueIndex = 0;
+        m_deltaTime = 0.0f;
+        return;
+    }
 
-    m_nextValueIndex = std::min(m_currentValueIndex + 1, values.size() - 1);
-    if(values[m_nextValueIndex].time < time)
+    // playback moves by a key or two per update, any other jump is a binary search
+    auto current = std::min(m_currentValueIndex, count - 2);
+    const auto isInSegment = [this, time](size_t index)
+    {
+        return m_track->getKeyTime(index) <= time && time < m_track->getKeyTime(index + 1);
+    };
+    if (!isInSegment(current))
     {
-        auto maxIndex = values.size() - 1;
-        do
+        if (current + 2 < count && isInSegment(current + 1))
         {
-            m_currentValueIndex++;
-        } while(m_currentValueIndex < maxIndex && values[m_currentValueIndex + 1].time < time);
-    }
-    else {
-        if (values[m_currentValueIndex].time > time) {
-            do {
-                m_currentValueIndex--;
-            } while (values[m_currentValueIndex].time > time && m_currentValueIndex > 0);
+            ++current;
+        }
+        else
+        {
+            current = std::min(std::max<size_t>(m_track->upperBound(time), 1) - 1, count - 2);
         }
     }
 
-    m_currentValueIndex = std::min(std::max(m_currentValueIndex, static_cast<size_t>(0)), values.size() - 2);
-    m_nextValueIndex = std::min(m_currentValueIndex + 1, values.size() - 1);
+    m_currentValueIndex = current;
+    m_nextValueIndex = current + 1;
 
-    if (m_currentValueIndex == m_nextValueIndex)
-    {
-        m_deltaTime = 0.0f;
-    } else {
-        m_deltaTime =
-                std::clamp((time - values[m_currentValueIndex].time) / (values[m_nextValueIndex].time - values[m_currentValueIndex].time), 0.0f, 1.0f);
-    }
+    const auto currentTime = m_track->getKeyTime(m_currentValueIndex);
+    const auto nextTime = m_track->getKeyTime(m_nextValueIndex);
+    m_deltaTime = nextTime > currentTime ? std::clamp((time - currentTime) / (nextTime - currentTime), 0.0f, 1.0f) : 0.0f;
 }
 
 template<typename T>
@@ -98,21 +183,21 @@ w4::sptr<Track<T>>& Track<T>::Accessor::getTrack()
 template<typename T>
 T Track<T>::Accessor::getValue() const
 {
-    const auto& values = m_track->getValues();
+    const auto& current = m_track->getKey(m_currentValueIndex);
 
-    switch (values[m_currentValueIndex].interp)
+    switch (current.interp)
     {
         case InterpType::CONST:
         {
-            return ConstInterpolate<T>::interpolate(values[m_currentValueIndex], values[m_nextValueIndex], m_deltaTime);
+            return current.value;
         }
         case InterpType::LERP:
         {
-            return LerpInterpolate<T>::interpolate(values[m_currentValueIndex], values[m_nextValueIndex], m_deltaTime);
+            return LerpInterpolate<T>::interpolate(current, m_track->getKey(m_nextValueIndex), m_deltaTime);
         }
         case InterpType::HERMIT:
         {
-            return HermitInterpolate<T>::interpolate(values[m_currentValueIndex], values[m_nextValueIndex], m_deltaTime);
+            return HermitInterpolate<T>::interpolate(current, m_track->getKey(m_nextValueIndex), m_deltaTime);
         }
         case InterpType::CUBIC:
         {
@@ -126,32 +211,32 @@ T Track<T>::Accessor::getValue() const
 template<typename T>
 typename Track<T>::Value Track<T>::Accessor::getValueByOffset(int offset) const
 {
-    const auto& values = m_track->getValues();
+    const auto count = m_track->getValuesCount();
     const auto newIndex = static_cast<int>(m_currentValueIndex) + offset;
-    if(values.empty())
+    if(count == 0)
     {
         return Track<T>::Value();
     }
-    if(values.size() == 1)
+    if(count == 1)
     {
-        return values[m_currentValueIndex];
+        return m_track->getKey(m_currentValueIndex);
     }
     if(newIndex < 0)
     {
-        return values[values.size() + newIndex];
+        return m_track->getKey(count + newIndex);
     }
-    else if(m_currentValueIndex == (values.size() - 1) && offset == 1)
+    else if(m_currentValueIndex == (count - 1) && offset == 1)
     {
         // never happens
-        return values[0]; // skip 0
+        return m_track->getKey(0); // skip 0
     }
-    else if(newIndex >= values.size())
+    else if(static_cast<size_t>(newIndex) >= count)
     {
-        return values[newIndex % values.size()];
+        return m_track->getKey(newIndex % count);
     }
     else
     {
-        return values[newIndex];
+        return m_track->getKey(newIndex);
     }
 }
 
@@ -173,13 +258,15 @@ Track<T>::Track(const ResourceLoadDescr& descr)
 template<typename T>
 bool Track<T>::isInRange(float time) const
 {
-    return m_values.size() == 0 ? false : time < m_values.back().time;
+    const auto count = getValuesCount();
+    return count == 0 ? false : time < getKeyTime(count - 1);
 }
 
 template<typename T>
 float Track<T>::getDuration() const
 {
-    return m_values.size() == 0 ? 0 : m_values.back().time;
+    const auto count = getValuesCount();
+    return count == 0 ? 0 : getKeyTime(count - 1);
 }
 
 template<typename T>
@@ -238,6 +325,81 @@ void Track<T>::setValues(Values && values)
     m_values.swap(values);
 }
 
+template<typename T>
+T Track<T>::sample(float time) const
+{
+    const auto count = getValuesCount();
+    if (count == 0)
+    {
+        return T();
+    }
+    if (count == 1)
+    {
+        return getKey(0).value;
+    }
+
+    const auto current = std::min(std::max<size_t>(upperBound(time), 1) - 1, count - 2);
+    const auto& a = getKey(current);
+    if (a.interp == InterpType::CONST)
+    {
+        // the next key is not decoded
+        return a.value;
+    }
+    const auto& b = getKey(current + 1);
+    const auto delta = b.time > a.time ? std::clamp((time - a.time) / (b.time - a.time), 0.0f, 1.0f) : 0.0f;
+
+    switch (a.interp)
+    {
+        case InterpType::CONST:
+            return a.value;
+        case InterpType::LERP:
+            return LerpInterpolate<T>::interpolate(a, b, delta);
+        case InterpType::HERMIT:
+            return HermitInterpolate<T>::interpolate(a, b, delta);
+        case InterpType::CUBIC:
+            return CubicInterpolate<T>::interpolate(getValueByOffset(current, -2), getValueByOffset(current, -1), a, b, delta);
+    }
+
+    return T();
+}
+
+template<typename T>
+float Track<T>::getKeyTime(size_t index) const
+{
+    return m_values[index].time;
+}
+
+template<typename T>
+const typename Track<T>::Value& Track<T>::getKey(size_t index) const
+{
+    return m_values[index];
+}
+
+template<typename T>
+size_t Track<T>::getMemorySize() const
+{
+    return sizeof(Values) + m_values.capacity() * sizeof(Value);
+}
+
+// same wrapping as Accessor::getValueByOffset
+template<typename T>
+const typename Track<T>::Value& Track<T>::getValueByOffset(size_t index, int offset) const
+{
+    const auto count = getValuesCount();
+    const auto newIndex = static_cast<int>(index) + offset;
+    if (newIndex < 0)
+    {
+        return getKey(count + newIndex);
+    }
+    return getKey(static_cast<size_t>(newIndex) % count);
+}
+
+template<typename T>
+size_t Track<T>::upperBound(float time) const
+{
+    return std::upper_bound(m_values.begin(), m_values.end(), time, [](float t, const Value& v) { return t < v.time; }) - m_values.begin();
+}
+
 template<typename T>
 void Track<T>::removeAccessor(Accessor* accessor)
 {
@@ -0,0 +1,108 @@
+template<typename T>
+void TransformChangeQueue<T>::push(T* node)
+{
+    if (m_pendingSet.insert(node).second)
+    {
+        m_pending.push_back(node);
+    }
+}
+
+template<typename T>
+void TransformChangeQueue<T>::erase(T* node)
+{
+    if (m_pending.empty())
+    {
+        return;
+    }
+
+    // children stay linked to a detached node, so the subtree can be walked after removal too
+    size_t erased = 0;
+    m_stack.clear();
+    m_stack.push_back(node);
+    while (!m_stack.empty())
+    {
+        auto current = m_stack.back();
+        m_stack.pop_back();
+        erased += m_pendingSet.erase(current);
+        for (auto& child: current->getChildren())
+        {
+            m_stack.push_back(child.get());
+        }
+    }
+
+    if (erased)
+    {
+        m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(), [this](const T* pending)
+        {
+            return m_pendingSet.count(pending) == 0;
+        }), m_pending.end());
+    }
+}
+
+template<typename T>
+void TransformChangeQueue<T>::clear()
+{
+    m_pending.clear();
+    m_pendingSet.clear();
+}
+
+template<typename T>
+bool TransformChangeQueue<T>::empty() const
+{
+    return m_pending.empty();
+}
+
+template<typename T>
+size_t TransformChangeQueue<T>::size() const
+{
+    return m_pending.size();
+}
+
+template<typename T>
+template<typename Callback>
+size_t TransformChangeQueue<T>::flush(Callback&& callback)
+{
+    // a changed node below another changed node is covered by the ancestor subtree walk
+    m_roots.clear();
+    for (auto node: m_pending)
+    {
+        if (!hasPendingAncestor(node))
+        {
+            m_roots.push_back(node);
+        }
+    }
+    clear();
+
+    // callbacks may move nodes again: those changes are queued for the next flush
+    size_t delivered = 0;
+    for (auto root: m_roots)
+    {
+        m_stack.clear();
+        m_stack.push_back(root);
+        while (!m_stack.empty())
+        {
+            auto node = m_stack.back();
+            m_stack.pop_back();
+            callback(*node);
+            ++delivered;
+            for (auto& child: node->getChildren())
+            {
+                m_stack.push_back(child.get());
+            }
+        }
+    }
+    return delivered;
+}
+
+template<typename T>
+bool TransformChangeQueue<T>::hasPendingAncestor(const T* node) const
+{
+    for (auto parent = node->getParent(); parent; parent = parent->getParent())
+    {
+        if (m_pendingSet.count(parent.get()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
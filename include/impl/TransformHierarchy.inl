@@ -0,0 +1,318 @@
+inline TransformHierarchy::Slot TransformHierarchy::add(Node* node, Slot parent, const math::Transform& local)
+{
+    Slot slot;
+    if (m_freeSlots.empty())
+    {
+        slot = static_cast<Slot>(m_indices.size());
+        m_indices.push_back(Dead);
+    }
+    else
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+
+    // appending keeps the depth order valid: the parent is already somewhere before
+    const auto index = static_cast<uint32_t>(m_nodes.size());
+    m_indices[slot] = index;
+    m_nodes.push_back(node);
+    m_slots.push_back(slot);
+    m_parents.push_back(parent == Null ? Dead : m_indices[parent]);
+    m_locals.push_back(local);
+    m_worlds.emplace_back();
+    m_matrices.emplace_back();
+    m_normals.emplace_back();
+    m_dirty.push_back(1);
+
+    ++m_count;
+    ++m_dirtyCount;
+    return slot;
+}
+
+inline void TransformHierarchy::remove(Slot slot)
+{
+    auto& index = m_indices[slot];
+    W4_ASSERT(index != Dead);
+
+    // the entry stays in the arrays until the next reorder, children of it become roots there
+    m_nodes[index] = nullptr;
+    m_slots[index] = Null;
+    if (m_dirty[index] == 0)
+    {
+        m_dirty[index] = 1;
+        ++m_dirtyCount;
+    }
+    index = Dead;
+    m_freeSlots.push_back(slot);
+
+    --m_count;
+    m_isOrderDirty = true;
+}
+
+inline void TransformHierarchy::setParent(Slot slot, Slot parent)
+{
+    const auto index = m_indices[slot];
+    const auto parentIndex = parent == Null ? Dead : m_indices[parent];
+    m_parents[index] = parentIndex;
+    if (!isOrderValid(parentIndex, index))
+    {
+        m_isOrderDirty = true;
+    }
+    if (m_dirty[index] == 0)
+    {
+        m_dirty[index] = 1;
+        ++m_dirtyCount;
+    }
+}
+
+inline void TransformHierarchy::setLocal(Slot slot, const math::Transform& local)
+{
+    const auto index = m_indices[slot];
+    m_locals[index] = local;
+    if (m_dirty[index] == 0)
+    {
+        m_dirty[index] = 1;
+        ++m_dirtyCount;
+    }
+}
+
+inline void TransformHierarchy::clear()
+{
+    m_nodes.clear();
+    m_slots.clear();
+    m_parents.clear();
+    m_locals.clear();
+    m_worlds.clear();
+    m_matrices.clear();
+    m_normals.clear();
+    m_dirty.clear();
+    m_indices.clear();
+    m_freeSlots.clear();
+    m_updated.clear();
+    m_count = 0;
+    m_dirtyCount = 0;
+    m_isOrderDirty = false;
+}
+
+inline Node* TransformHierarchy::getNode(Slot slot) const
+{
+    return m_nodes[m_indices[slot]];
+}
+
+inline TransformHierarchy::Slot TransformHierarchy::getParent(Slot slot) const
+{
+    const auto parentIndex = m_parents[m_indices[slot]];
+    return parentIndex == Dead ? Null : m_slots[parentIndex];
+}
+
+inline const math::Transform& TransformHierarchy::getLocal(Slot slot) const
+{
+    return m_locals[m_indices[slot]];
+}
+
+inline const math::Transform& TransformHierarchy::getWorld(Slot slot)
+{
+    auto index = m_indices[slot];
+    resolve(index);
+    return m_worlds[index];
+}
+
+inline const math::mat4& TransformHierarchy::getWorldMatrix(Slot slot)
+{
+    auto index = m_indices[slot];
+    resolve(index);
+    return m_matrices[index];
+}
+
+inline const math::mat3& TransformHierarchy::getNormalMatrix(Slot slot)
+{
+    auto index = m_indices[slot];
+    resolve(index);
+    return m_normals[index];
+}
+
+inline size_t TransformHierarchy::update()
+{
+    m_updated.clear();
+    if (m_isOrderDirty)
+    {
+        reorder();
+    }
+    if (m_dirtyCount == 0)
+    {
+        return 0;
+    }
+
+    // parents precede children, so a parent dirty flag is final when the child is visited
+    const auto count = static_cast<uint32_t>(m_nodes.size());
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const auto parent = m_parents[i];
+        if (parent != Dead && m_dirty[parent])
+        {
+            m_dirty[i] = 1;
+        }
+        if (m_dirty[i])
+        {
+            compute(i);
+            m_updated.push_back(m_nodes[i]);
+        }
+    }
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    m_dirtyCount = 0;
+    return m_updated.size();
+}
+
+inline const std::vector<Node*>& TransformHierarchy::getUpdated() const
+{
+    return m_updated;
+}
+
+inline size_t TransformHierarchy::size() const
+{
+    return m_count;
+}
+
+inline bool TransformHierarchy::isDirty() const
+{
+    return m_dirtyCount != 0 || m_isOrderDirty;
+}
+
+inline void TransformHierarchy::reorder()
+{
+    const auto count = static_cast<uint32_t>(m_nodes.size());
+
+    // depths of live entries, parents of removed entries are cut off
+    std::vector<uint32_t> depths(count, Dead);
+    uint32_t maxDepth = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (m_nodes[i] == nullptr || depths[i] != Dead)
+        {
+            continue;
+        }
+        m_chain.clear();
+        uint32_t current = i;
+        uint32_t depth = 0;
+        while (current != Dead && depths[current] == Dead)
+        {
+            m_chain.push_back(current);
+            const auto parent = m_parents[current];
+            if (parent != Dead && m_nodes[parent] == nullptr)
+            {
+                m_parents[current] = Dead;
+                if (m_dirty[current] == 0)
+                {
+                    m_dirty[current] = 1;
+                    ++m_dirtyCount;
+                }
+            }
+            current = m_parents[current];
+        }
+        if (current != Dead)
+        {
+            depth = depths[current] + 1;
+        }
+        for (auto it = m_chain.rbegin(); it != m_chain.rend(); ++it)
+        {
+            depths[*it] = depth++;
+        }
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    // stable counting sort by depth
+    std::vector<uint32_t> offsets(maxDepth + 1, 0);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (depths[i] != Dead)
+        {
+            ++offsets[depths[i] + 1];
+        }
+    }
+    for (size_t d = 1; d < offsets.size(); ++d)
+    {
+        offsets[d] += offsets[d - 1];
+    }
+    std::vector<uint32_t> order(m_count);
+    std::vector<uint32_t> remap(count, Dead);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (depths[i] != Dead)
+        {
+            remap[i] = offsets[depths[i]]++;
+            order[remap[i]] = i;
+        }
+    }
+
+    auto permute = [&order](auto& values)
+    {
+        std::remove_reference_t<decltype(values)> result;
+        result.reserve(order.size());
+        for (auto i: order)
+        {
+            result.push_back(values[i]);
+        }
+        values.swap(result);
+    };
+    permute(m_nodes);
+    permute(m_slots);
+    permute(m_parents);
+    permute(m_locals);
+    permute(m_worlds);
+    permute(m_matrices);
+    permute(m_normals);
+    permute(m_dirty);
+
+    m_dirtyCount = 0;
+    for (uint32_t i = 0; i < m_count; ++i)
+    {
+        auto& parent = m_parents[i];
+        parent = parent == Dead ? Dead : remap[parent];
+        m_indices[m_slots[i]] = i;
+        m_dirtyCount += m_dirty[i];
+    }
+    m_isOrderDirty = false;
+}
+
+inline void TransformHierarchy::resolve(uint32_t& index)
+{
+    if (m_dirtyCount == 0)
+    {
+        return;
+    }
+    if (m_isOrderDirty)
+    {
+        const auto slot = m_slots[index];
+        reorder();
+        index = m_indices[slot];
+    }
+
+    // recompute the chain below the topmost dirty ancestor, dirty flags stay for update()
+    m_chain.clear();
+    uint32_t top = Dead;
+    for (auto current = index; current != Dead; current = m_parents[current])
+    {
+        m_chain.push_back(current);
+        if (m_dirty[current])
+        {
+            top = static_cast<uint32_t>(m_chain.size());
+        }
+    }
+    for (uint32_t i = top == Dead ? 0 : top; i > 0; --i)
+    {
+        compute(m_chain[i - 1]);
+    }
+}
+
+inline void TransformHierarchy::compute(uint32_t index)
+{
+    const auto parent = m_parents[index];
+    m_worlds[index] = parent == Dead ? m_locals[index] : m_worlds[parent] + m_locals[index];
+    m_matrices[index] = m_worlds[index].getMatrix();
+    m_normals[index] = m_worlds[index].getTransposedInverseMat3();
+}
+
+inline bool TransformHierarchy::isOrderValid(uint32_t parentIndex, uint32_t index) const
+{
+    return parentIndex == Dead || parentIndex < index;
+}
@@ -77,6 +77,13 @@ void UserVerticesBuffer<VertexFormat>::removeVertex(size_t index)
     m_vertices.erase(m_vertices.begin() + index);
 }
 
+template<typename VertexFormat>
+VertexFormat* UserVerticesBuffer<VertexFormat>::resize(size_t verticesCount)
+{
+    m_vertices.resize(verticesCount);
+    return m_vertices.data();
+}
+
 template<typename VertexFormat>
 BufferUsage UserVerticesBuffer<VertexFormat>::getUsage() const
 {
@@ -97,10 +97,9 @@ inline vec3 mat3::operator*(const vec3& rhs) const
 
 inline vec4 mat4::operator*(const vec4& rhs) const
 {
-    return vec4(data[0] * rhs.x + data[4] * rhs.y + data[8] * rhs.z + data[12] * rhs.w,
-                data[1] * rhs.x + data[5] * rhs.y + data[9] * rhs.z + data[13] * rhs.w,
-                data[2] * rhs.x + data[6] * rhs.y + data[10] * rhs.z + data[14] * rhs.w,
-                data[3] * rhs.x + data[7] * rhs.y + data[11] * rhs.z + data[15] * rhs.w);
+    vec4 result;
+    simd::mulMat4Vec4(data, rhs.elements, result.elements);
+    return result;
 }
 
 inline Rotator mat4::operator*(const Rotator& rhs) const
@@ -111,6 +110,58 @@ inline Rotator mat4::operator*(const Rotator& rhs) const
                    data[3] * rhs.quaternion.x + data[7]*rhs.quaternion.y + data[11]*rhs.quaternion.z + data[15]*rhs.quaternion.w);
 }
 
+static_assert(sizeof(vec3) == sizeof(float) * 3 && sizeof(vec4) == sizeof(float) * 4 && sizeof(mat4) == sizeof(float) * 16,
+              "batch math expects tightly packed vectors and matrices");
+
+inline mat4 multiply(mat4::cref lhs, mat4::cref rhs)
+{
+    mat4 result;
+    simd::mulMat4(lhs.data, rhs.data, result.data);
+    return result;
+}
+
+inline Quaternion multiply(Quaternion::cref lhs, Quaternion::cref rhs)
+{
+    Quaternion result;
+    simd::mulQuat(lhs.elements, rhs.elements, result.elements);
+    return result;
+}
+
+inline void transformPoints(mat4::cref m, const vec3* points, vec3* out, size_t count)
+{
+    simd::mulMat4Vec3Batch(m.data, reinterpret_cast<const float*>(points), reinterpret_cast<float*>(out), count, 1.f);
+}
+
+inline void transformDirections(mat4::cref m, const vec3* directions, vec3* out, size_t count)
+{
+    simd::mulMat4Vec3Batch(m.data, reinterpret_cast<const float*>(directions), reinterpret_cast<float*>(out), count, 0.f);
+}
+
+inline void transformVectors(mat4::cref m, const vec4* vectors, vec4* out, size_t count)
+{
+    simd::mulMat4Vec4Batch(m.data, reinterpret_cast<const float*>(vectors), reinterpret_cast<float*>(out), count);
+}
+
+inline void multiply(mat4::cref parent, const mat4* matrices, mat4* out, size_t count)
+{
+    simd::composeMat4Batch(parent.data, reinterpret_cast<const float*>(matrices), reinterpret_cast<float*>(out), count);
+}
+
+inline void multiply(const mat4* lhs, const mat4* rhs, mat4* out, size_t count)
+{
+    simd::mulMat4Batch(reinterpret_cast<const float*>(lhs), reinterpret_cast<const float*>(rhs), reinterpret_cast<float*>(out), count);
+}
+
+inline void compose(Transform::cref parent, const Transform* locals, mat4* out, size_t count)
+{
+    const auto parentMatrix = parent.getMatrix();
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = locals[i].getMatrix();
+    }
+    multiply(parentMatrix, out, out, count);
+}
+
 template<class T>
 typename std::enable_if<!std::numeric_limits<T>::is_integer, bool>::type
 equals(const T &x, const T &y, int ulp) {
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+/*
+ * SIMD backend of w4::math, selected at compile time:
+ *      - wasm simd128 under Emscripten with -msimd128
+ *      - SSE2 on x86, NEON on ARM
+ *      - scalar fallback otherwise or with W4_MATH_NO_SIMD
+ * kernels work on column-major float arrays and use unaligned loads:
+ * mat4/vec4 keep their 4-byte alignment, the engine library is built against that layout
+ * */
+
+#if !defined(W4_MATH_NO_SIMD) && defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define W4_MATH_SIMD_WASM 1
+    #define W4_MATH_SIMD "wasm_simd128"
+#elif !defined(W4_MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define W4_MATH_SIMD_SSE 1
+    #define W4_MATH_SIMD "sse2"
+#elif !defined(W4_MATH_NO_SIMD) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define W4_MATH_SIMD_NEON 1
+    #define W4_MATH_SIMD "neon"
+#else
+    #define W4_MATH_SIMD_SCALAR 1
+    #define W4_MATH_SIMD "scalar"
+#endif
+
+namespace w4::math::simd {
+
+#if defined(W4_MATH_SIMD_WASM)
+    using f4 = v128_t;
+
+    inline f4 load(const float* p) { return wasm_v128_load(p); }
+    inline void store(float* p, f4 v) { wasm_v128_store(p, v); }
+    inline f4 set(float x, float y, float z, float w) { return wasm_f32x4_make(x, y, z, w); }
+    inline f4 splat(float v) { return wasm_f32x4_splat(v); }
+    inline f4 add(f4 a, f4 b) { return wasm_f32x4_add(a, b); }
+    inline f4 sub(f4 a, f4 b) { return wasm_f32x4_sub(a, b); }
+    inline f4 mul(f4 a, f4 b) { return wasm_f32x4_mul(a, b); }
+    inline f4 div(f4 a, f4 b) { return wasm_f32x4_div(a, b); }
+    inline f4 sqrt(f4 v) { return wasm_f32x4_sqrt(v); }
+    inline f4 min(f4 a, f4 b) { return wasm_f32x4_pmin(a, b); }
+    inline f4 max(f4 a, f4 b) { return wasm_f32x4_pmax(a, b); }
+    template<int I0, int I1, int I2, int I3>
+    inline f4 shuffle(f4 v) { return wasm_i32x4_shuffle(v, v, I0, I1, I2, I3); }
+#elif defined(W4_MATH_SIMD_SSE)
+    using f4 = __m128;
+
+    inline f4 load(const float* p) { return _mm_loadu_ps(p); }
+    inline void store(float* p, f4 v) { _mm_storeu_ps(p, v); }
+    inline f4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+    inline f4 splat(float v) { return _mm_set1_ps(v); }
+    inline f4 add(f4 a, f4 b) { return _mm_add_ps(a, b); }
+    inline f4 sub(f4 a, f4 b) { return _mm_sub_ps(a, b); }
+    inline f4 mul(f4 a, f4 b) { return _mm_mul_ps(a, b); }
+    inline f4 div(f4 a, f4 b) { return _mm_div_ps(a, b); }
+    inline f4 sqrt(f4 v) { return _mm_sqrt_ps(v); }
+    inline f4 min(f4 a, f4 b) { return _mm_min_ps(a, b); }
+    inline f4 max(f4 a, f4 b) { return _mm_max_ps(a, b); }
+    template<int I0, int I1, int I2, int I3>
+    inline f4 shuffle(f4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I3, I2, I1, I0)); }
+#elif defined(W4_MATH_SIMD_NEON)
+    using f4 = float32x4_t;
+
+    inline f4 load(const float* p) { return vld1q_f32(p); }
+    inline void store(float* p, f4 v) { vst1q_f32(p, v); }
+    inline f4 set(float x, float y, float z, float w) { const float v[4] = {x, y, z, w}; return vld1q_f32(v); }
+    inline f4 splat(float v) { return vdupq_n_f32(v); }
+    inline f4 add(f4 a, f4 b) { return vaddq_f32(a, b); }
+    inline f4 sub(f4 a, f4 b) { return vsubq_f32(a, b); }
+    inline f4 mul(f4 a, f4 b) { return vmulq_f32(a, b); }
+    inline f4 min(f4 a, f4 b) { return vminq_f32(a, b); }
+    inline f4 max(f4 a, f4 b) { return vmaxq_f32(a, b); }
+    #if defined(__aarch64__)
+    inline f4 div(f4 a, f4 b) { return vdivq_f32(a, b); }
+    inline f4 sqrt(f4 v) { return vsqrtq_f32(v); }
+    #else
+    // no vector divide and square root on ARMv7 NEON
+    inline f4 div(f4 a, f4 b)
+    {
+        float x[4], y[4];
+        vst1q_f32(x, a);
+        vst1q_f32(y, b);
+        return set(x[0] / y[0], x[1] / y[1], x[2] / y[2], x[3] / y[3]);
+    }
+    inline f4 sqrt(f4 v)
+    {
+        float x[4];
+        vst1q_f32(x, v);
+        return set(std::sqrt(x[0]), std::sqrt(x[1]), std::sqrt(x[2]), std::sqrt(x[3]));
+    }
+    #endif
+    template<int I0, int I1, int I2, int I3>
+    inline f4 shuffle(f4 v)
+    {
+    #if defined(__clang__)
+        return __builtin_shufflevector(v, v, I0, I1, I2, I3);
+    #else
+        return __builtin_shuffle(v, uint32x4_t{I0, I1, I2, I3});
+    #endif
+    }
+#else
+    struct f4
+    {
+        float e[4];
+    };
+
+    inline f4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    inline void store(float* p, f4 v) { p[0] = v.e[0]; p[1] = v.e[1]; p[2] = v.e[2]; p[3] = v.e[3]; }
+    inline f4 set(float x, float y, float z, float w) { return {{x, y, z, w}}; }
+    inline f4 splat(float v) { return {{v, v, v, v}}; }
+    inline f4 add(f4 a, f4 b) { return {{a.e[0] + b.e[0], a.e[1] + b.e[1], a.e[2] + b.e[2], a.e[3] + b.e[3]}}; }
+    inline f4 sub(f4 a, f4 b) { return {{a.e[0] - b.e[0], a.e[1] - b.e[1], a.e[2] - b.e[2], a.e[3] - b.e[3]}}; }
+    inline f4 mul(f4 a, f4 b) { return {{a.e[0] * b.e[0], a.e[1] * b.e[1], a.e[2] * b.e[2], a.e[3] * b.e[3]}}; }
+    inline f4 div(f4 a, f4 b) { return {{a.e[0] / b.e[0], a.e[1] / b.e[1], a.e[2] / b.e[2], a.e[3] / b.e[3]}}; }
+    inline f4 sqrt(f4 v) { return {{std::sqrt(v.e[0]), std::sqrt(v.e[1]), std::sqrt(v.e[2]), std::sqrt(v.e[3])}}; }
+    inline f4 min(f4 a, f4 b) { return {{std::min(a.e[0], b.e[0]), std::min(a.e[1], b.e[1]), std::min(a.e[2], b.e[2]), std::min(a.e[3], b.e[3])}}; }
+    inline f4 max(f4 a, f4 b) { return {{std::max(a.e[0], b.e[0]), std::max(a.e[1], b.e[1]), std::max(a.e[2], b.e[2]), std::max(a.e[3], b.e[3])}}; }
+    template<int I0, int I1, int I2, int I3>
+    inline f4 shuffle(f4 v) { return {{v.e[I0], v.e[I1], v.e[I2], v.e[I3]}}; }
+#endif
+
+// a * b + c, kept as two operations so every backend rounds the same way
+inline f4 madd(f4 a, f4 b, f4 c)
+{
+    return add(mul(a, b), c);
+}
+
+template<int I>
+inline f4 lane(f4 v)
+{
+    return shuffle<I, I, I, I>(v);
+}
+
+// out = a * b, column-major 4x4; out may alias a or b
+inline void mulMat4(const float* a, const float* b, float* out)
+{
+    const f4 a0 = load(a);
+    const f4 a1 = load(a + 4);
+    const f4 a2 = load(a + 8);
+    const f4 a3 = load(a + 12);
+    f4 result[4];
+    for (int c = 0; c < 4; ++c)
+    {
+        const f4 column = load(b + c * 4);
+        f4 r = mul(a0, lane<0>(column));
+        r = madd(a1, lane<1>(column), r);
+        r = madd(a2, lane<2>(column), r);
+        r = madd(a3, lane<3>(column), r);
+        result[c] = r;
+    }
+    for (int c = 0; c < 4; ++c)
+    {
+        store(out + c * 4, result[c]);
+    }
+}
+
+// out = m * v; out may alias v
+inline void mulMat4Vec4(const float* m, const float* v, float* out)
+{
+    const f4 column = load(v);
+    f4 r = mul(load(m), lane<0>(column));
+    r = madd(load(m + 4), lane<1>(column), r);
+    r = madd(load(m + 8), lane<2>(column), r);
+    r = madd(load(m + 12), lane<3>(column), r);
+    store(out, r);
+}
+
+// Hamilton product of (x, y, z, w) quaternions; out may alias a or b
+inline void mulQuat(const float* a, const float* b, float* out)
+{
+    const f4 qa = load(a);
+    const f4 qb = load(b);
+    f4 r = mul(lane<3>(qa), qb);
+    r = madd(lane<0>(qa), mul(shuffle<3, 2, 1, 0>(qb), set( 1.f, -1.f,  1.f, -1.f)), r);
+    r = madd(lane<1>(qa), mul(shuffle<2, 3, 0, 1>(qb), set( 1.f,  1.f, -1.f, -1.f)), r);
+    r = madd(lane<2>(qa), mul(shuffle<1, 0, 3, 2>(qb), set(-1.f,  1.f,  1.f, -1.f)), r);
+    store(out, r);
+}
+
+// out[i] = a[i] * b[i] for count matrices, 16 floats each
+inline void mulMat4Batch(const float* a, const float* b, float* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        mulMat4(a + i * 16, b + i * 16, out + i * 16);
+    }
+}
+
+// out[i] = parent * local[i], the parent columns stay in registers
+inline void composeMat4Batch(const float* parent, const float* local, float* out, size_t count)
+{
+    const f4 p0 = load(parent);
+    const f4 p1 = load(parent + 4);
+    const f4 p2 = load(parent + 8);
+    const f4 p3 = load(parent + 12);
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            const f4 column = load(local + i * 16 + c * 4);
+            f4 r = mul(p0, lane<0>(column));
+            r = madd(p1, lane<1>(column), r);
+            r = madd(p2, lane<2>(column), r);
+            r = madd(p3, lane<3>(column), r);
+            store(out + i * 16 + c * 4, r);
+        }
+    }
+}
+
+// out[i] = m * v[i] for count vec4
+inline void mulMat4Vec4Batch(const float* m, const float* v, float* out, size_t count)
+{
+    const f4 m0 = load(m);
+    const f4 m1 = load(m + 4);
+    const f4 m2 = load(m + 8);
+    const f4 m3 = load(m + 12);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const f4 column = load(v + i * 4);
+        f4 r = mul(m0, lane<0>(column));
+        r = madd(m1, lane<1>(column), r);
+        r = madd(m2, lane<2>(column), r);
+        r = madd(m3, lane<3>(column), r);
+        store(out + i * 4, r);
+    }
+}
+
+// out[i] = m * (in[i], w) for tightly packed xyz triples; out may alias in
+inline void mulMat4Vec3Batch(const float* m, const float* in, float* out, size_t count, float w)
+{
+    const f4 m0 = load(m);
+    const f4 m1 = load(m + 4);
+    const f4 m2 = load(m + 8);
+    const f4 base = mul(load(m + 12), splat(w));
+    float result[4];
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float* p = in + i * 3;
+        f4 r = madd(m0, splat(p[0]), base);
+        r = madd(m1, splat(p[1]), r);
+        r = madd(m2, splat(p[2]), r);
+        store(result, r);
+        float* o = out + i * 3;
+        o[0] = result[0];
+        o[1] = result[1];
+        o[2] = result[2];
+    }
+}
+
+// reference implementations, used by the benchmark and for validation
+namespace scalar {
+
+inline void mulMat4(const float* a, const float* b, float* out)
+{
+    float result[16];
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+            result[c * 4 + r] = a[r] * b[c * 4] + a[4 + r] * b[c * 4 + 1] + a[8 + r] * b[c * 4 + 2] + a[12 + r] * b[c * 4 + 3];
+        }
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        out[i] = result[i];
+    }
+}
+
+inline void mulMat4Vec4(const float* m, const float* v, float* out)
+{
+    float result[4];
+    for (int r = 0; r < 4; ++r)
+    {
+        result[r] = m[r] * v[0] + m[4 + r] * v[1] + m[8 + r] * v[2] + m[12 + r] * v[3];
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        out[i] = result[i];
+    }
+}
+
+inline void mulQuat(const float* a, const float* b, float* out)
+{
+    const float x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+    const float y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+    const float z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+    const float w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+    out[3] = w;
+}
+
+} // namespace scalar
+
+} // namespace w4::math::simd
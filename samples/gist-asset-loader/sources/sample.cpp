@@ -0,0 +1,76 @@
+#include "W4Framework.h"
+
+W4_USE_UNSTRICT_INTERFACE
+
+// loads utah-teapot.w4a through AssetLoader, the grid of teapots built from it is one step per teapot within a 2 ms frame budget;
+// TAP while loading to cancel
+class GistAssetLoader : public IGame
+{
+    static constexpr int Side = 8;
+    static constexpr float Spacing = 12.f;
+
+    void onStart() override
+    {
+        Render::getScreenCamera()->setWorldTranslation({0, 0, -130});
+
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 300));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        m_grid = make::sptr<Node>("grid");
+        Render::getRoot()->addChild(m_grid);
+
+        AssetLoader::setFrameBudget(2.f);
+        m_task = AssetLoader::load("utah-teapot.w4a", [this](const sptr<Asset>&, AssetLoadTask::State state)
+        {
+            const auto name = state == AssetLoadTask::State::Completed ? "completed" : state == AssetLoadTask::State::Cancelled ? "cancelled" : "failed";
+            m_label->setText(utils::format("%s: %d teapots in %d frames", name, m_teapots, m_frames));
+        }, [this](const AssetLoadTask::Progress& progress)
+        {
+            m_label->setText(utils::format("loading %d%% (%u of %u steps)", static_cast<int>(progress.getFraction() * 100), progress.stepsDone, progress.stepsTotal));
+        });
+
+        // these steps run after Asset::load, each clones one teapot out of the loaded asset
+        for (int i = 0; i < Side * Side; ++i)
+        {
+            m_task->addStep([this, i]()
+            {
+                auto source = m_task->getAsset()->getFirstRoot()->getChild<Mesh>("Utah Teapot Quads");
+                if (!source)
+                {
+                    return false;
+                }
+                auto teapot = source->clone();
+                teapot->setWorldTranslation({(i % Side - Side / 2 + .5f) * Spacing, (i / Side - Side / 2 + .5f) * Spacing, 0});
+                teapot->setWorldScale({.15f, .15f, .15f});
+                m_grid->addChild(teapot);
+                ++m_teapots;
+                return true;
+            });
+        }
+    }
+
+    void onTouch(const event::Touch::Begin&) override
+    {
+        m_task->cancel();
+    }
+
+    void onUpdate(float dt) override
+    {
+        if (!m_task->isFinished())
+        {
+            ++m_frames;
+        }
+        AssetLoader::update();
+        m_grid->rotateLocal(Rotator(0, dt * .5f, 0));
+    }
+
+private:
+    sptr<Label> m_label;
+    sptr<Node> m_grid;
+    sptr<AssetLoadTask> m_task;
+    int m_teapots = 0;
+    int m_frames = 0;
+};
+
+W4_RUN(GistAssetLoader)
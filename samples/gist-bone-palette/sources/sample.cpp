@@ -0,0 +1,64 @@
+#include "W4Framework.h"
+
+W4_USE_UNSTRICT_INTERFACE
+
+// a crowd of skinned meshes: SkinnedMesh splits each surface into sub-surfaces whose bones fit the w4_u_bones palette
+// (SkinnedMesh::maxBonesPerSurface uniforms), every sub-surface is a draw of its own
+class GistBonePalette : public IGame
+{
+    static constexpr int Rows = 4;
+    static constexpr int Columns = 8;
+
+    void onStart() override
+    {
+        Render::getScreenCamera()->setWorldTranslation({0, 150, -600});
+
+        m_crowd = make::sptr<Node>("crowd");
+        Render::getRoot()->addChild(m_crowd);
+
+        std::vector<sptr<SkinnedMesh>> meshes;
+        const auto root = Asset::get("SK_PaperBoy_T_Pose.w4a")->getFirstRoot();
+        for (int row = 0; row < Rows; ++row)
+        {
+            for (int column = 0; column < Columns; ++column)
+            {
+                auto character = root->clone();
+                character->setLocalTranslation({(column - Columns / 2 + .5f) * 60.f, 0, (row - Rows / 2 + .5f) * 80.f});
+                m_crowd->addChild(character);
+                character->traversalTyped<SkinnedMesh>([&meshes](cref<SkinnedMesh> node)
+                {
+                    meshes.emplace_back(node);
+                });
+            }
+        }
+
+        size_t surfaces = 0;
+        size_t draws = 0;
+        for (const auto& mesh: meshes)
+        {
+            static_cast<const SkinnedMesh&>(*mesh).foreachSkeletonSplitSurface([&surfaces, &draws](const SkeletonSplitSurface& surface)
+            {
+                ++surfaces;
+                draws += surface.getSubSurfaces().size();
+            });
+        }
+
+        const auto bonesCount = static_cast<size_t>(meshes.front()->getSkeleton()->getBonesCount());
+        auto label = gui::createWidget<Label>(nullptr, "", ivec2(540, 300));
+        label->setHorizontalAlign(HorizontalAlign::Center);
+        label->setText(utils::format("%zu skinned meshes, %zu bones each\n%zu surfaces drawn as %zu sub-surfaces\nof at most %zu bones",
+                                     meshes.size(), bonesCount, surfaces, draws, static_cast<size_t>(SkinnedMesh::maxBonesPerSurface)));
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+        W4_LOG_INFO("%zu skinned meshes, %zu bones: %zu surfaces, %zu draws", meshes.size(), bonesCount, surfaces, draws);
+    }
+
+    void onUpdate(float dt) override
+    {
+        m_crowd->rotateLocal(Rotator(0, dt * .3f, 0));
+    }
+
+private:
+    sptr<Node> m_crowd;
+};
+
+W4_RUN(GistBonePalette)
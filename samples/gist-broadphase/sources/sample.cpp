@@ -0,0 +1,190 @@
+#include "W4Framework.h"
+#include "AABBTree.h"
+#include "Broadphase.h"
+#include "RaycastTree.h"
+
+W4_USE_UNSTRICT_INTERFACE
+
+// cubes drifting inside a box: an AABBTree over their world bounds answers "what does the camera see" with one frustum query,
+// SweepAndPrune finds the touching cubes and a PairTable keeps their contacts between frames,
+// a touch shoots a spread of rays through a RaycastTree of the cube colliders as one batch
+class GistBroadphase : public IGame
+{
+    static constexpr size_t Count = 300;
+    static constexpr float Extent = 30.f;
+    static constexpr float HalfSize = 1.f;
+    inline static const color IdleColor = color(.4f, .6f, .9f, 1.f);
+    inline static const color TouchingColor = color(1.f, .4f, .2f, 1.f);
+
+    static constexpr uint8_t CubesGroup = 1;
+    static constexpr int Spread = 2;
+    static constexpr int SpreadStep = 40;
+
+    struct Body
+    {
+        sptr<Mesh> mesh;
+        vec3 velocity;
+        AABBTree<size_t>::ProxyId proxy;
+        SweepAndPrune<size_t>::ProxyId sweepProxy;
+        Collider* collider;
+        uint32_t contacts = 0;
+    };
+
+    void onStart() override
+    {
+        Render::getScreenCamera()->setWorldTranslation({0, 0, -90});
+
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 300));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        m_bodies.reserve(Count);
+        for (size_t i = 0; i < Count; ++i)
+        {
+            auto mesh = Mesh::create::cube({HalfSize * 2, HalfSize * 2, HalfSize * 2});
+            mesh->setWorldTranslation({random<float>(-Extent, Extent), random<float>(-Extent, Extent), random<float>(-Extent, Extent)});
+            Render::getRoot()->addChild(mesh);
+
+            const vec3 velocity(random<float>(-5, 5), random<float>(-5, 5), random<float>(-5, 5));
+            const auto bounds = getBounds(*mesh);
+            auto collider = mesh->addCollider<core::AABB>(vec3(HalfSize * 2, HalfSize * 2, HalfSize * 2)).get();
+            m_bodies.push_back({mesh, velocity, m_tree.insert(bounds, i), m_sweep.add(i, bounds, CubesGroup), collider});
+            m_raycast.add(collider);
+            m_colliders.emplace(collider, i);
+            mesh->getMaterialInst()->setParam("baseColor", IdleColor);
+        }
+        // the incremental inserts are fine for the moves, a median split tree is tighter to start from
+        m_tree.rebuild();
+    }
+
+    void onUpdate(float dt) override
+    {
+        m_time += dt;
+
+        size_t reinserted = 0;
+        for (auto& body: m_bodies)
+        {
+            auto position = body.mesh->getWorldTranslation() + body.velocity * dt;
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                if (std::abs(position[axis]) > Extent && position[axis] * body.velocity[axis] > 0)
+                {
+                    body.velocity[axis] = -body.velocity[axis];
+                }
+            }
+            body.mesh->setWorldTranslation(position);
+            const auto bounds = getBounds(*body.mesh);
+            reinserted += m_tree.move(body.proxy, bounds) ? 1 : 0;
+            m_sweep.update(body.sweepProxy, bounds);
+            m_raycast.update(body.collider);
+        }
+
+        // every touching pair is reported twice, as (a, b) and (b, a), one of them is kept
+        ++m_frame;
+        size_t began = 0;
+        m_sweep.findPairs(CubesGroup, CubesGroup, [this, &began](size_t source, size_t target)
+        {
+            if (source > target)
+            {
+                return;
+            }
+            auto& lastFrame = m_contacts(source, target);
+            if (lastFrame == 0)
+            {
+                ++began;
+                addContact(source, 1);
+                addContact(target, 1);
+            }
+            lastFrame = m_frame;
+        });
+        size_t ended = 0;
+        m_contacts.retain([this, &ended](const PairTable<size_t, uint32_t>::Entry& entry)
+        {
+            if (entry.value == m_frame)
+            {
+                return true;
+            }
+            ++ended;
+            addContact(entry.first, -1);
+            addContact(entry.second, -1);
+            return false;
+        });
+
+        auto camera = Render::getScreenCamera();
+        camera->setWorldRotation(Rotator(0, std::sin(m_time * .3f) * .8f, 0));
+
+        size_t visible = 0;
+        const auto stats = m_tree.queryFrustum(camera->getFrustum(), [&visible](size_t, bool)
+        {
+            ++visible;
+        });
+
+        if (++m_frames == 30)
+        {
+            m_frames = 0;
+            m_label->setText(utils::format("%zu cubes, %zu in view\nfrustum: %u tree nodes tested\nmoves: %zu reinserted\ncontacts: %zu (+%zu -%zu)\nlast shot: %zu of %zu rays hit",
+                                           m_bodies.size(), visible, stats.tested, reinserted, m_contacts.size(), began, ended, m_hits, m_rays.size()));
+        }
+    }
+
+    // every ray of the spread pushes the closest cube it hits away from the camera
+    void onTouch(const event::Touch::Begin& event) override
+    {
+        m_rays.clear();
+        for (int y = -Spread; y <= Spread; ++y)
+        {
+            for (int x = -Spread; x <= Spread; ++x)
+            {
+                m_rays.push_back(Render::createRayFromScreen({event.point.x + x * SpreadStep, event.point.y + y * SpreadStep}));
+            }
+        }
+        const auto results = m_raycast.raycast(m_rays);
+
+        m_hits = 0;
+        for (size_t i = 0; i < m_rays.size(); ++i)
+        {
+            if (const auto* target = results[i].target)
+            {
+                ++m_hits;
+                m_bodies[m_colliders[target]].velocity = m_rays[i].direction * 20.f;
+            }
+        }
+    }
+
+private:
+    // touching cubes are tinted while they have at least one contact
+    void addContact(size_t index, int delta)
+    {
+        auto& body = m_bodies[index];
+        const bool wasTouching = body.contacts > 0;
+        body.contacts += delta;
+        if (wasTouching != (body.contacts > 0))
+        {
+            body.mesh->getMaterialInst()->setParam("baseColor", body.contacts > 0 ? TouchingColor : IdleColor);
+        }
+    }
+
+    static Bounds getBounds(const Mesh& mesh)
+    {
+        const auto& center = mesh.getWorldTranslation();
+        return {center - vec3(HalfSize, HalfSize, HalfSize), center + vec3(HalfSize, HalfSize, HalfSize)};
+    }
+
+    sptr<Label> m_label;
+    std::vector<Body> m_bodies;
+    AABBTree<size_t> m_tree{.5f};
+    SweepAndPrune<size_t> m_sweep;
+    // value: the last frame the pair was found touching
+    PairTable<size_t, uint32_t> m_contacts;
+    uint32_t m_frame = 0;
+
+    RaycastTree m_raycast;
+    std::unordered_map<const Collider*, size_t> m_colliders;
+    std::vector<Ray> m_rays;
+    size_t m_hits = 0;
+
+    float m_time = 0;
+    int m_frames = 0;
+};
+
+W4_RUN(GistBroadphase)
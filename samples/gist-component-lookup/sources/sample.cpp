@@ -0,0 +1,115 @@
+#include "W4Framework.h"
+
+#include <chrono>
+#include <random>
+
+W4_USE_UNSTRICT_INTERFACE
+
+class Health : public core::IComponent
+{
+    W4_COMPONENT(Health, core::IComponent)
+    W4_COMPONENT_DISABLE_CLONING
+
+public:
+    float m_value = 100.f;
+};
+
+class Speed : public core::IComponent
+{
+    W4_COMPONENT(Speed, core::IComponent)
+    W4_COMPONENT_DISABLE_CLONING
+
+public:
+    float m_value = 1.f;
+};
+
+class Score : public core::IComponent
+{
+    W4_COMPONENT(Score, core::IComponent)
+    W4_COMPONENT_DISABLE_CLONING
+
+public:
+    float m_value = 0.f;
+};
+
+// typed component lookups in a gameplay loop: Node::getComponent / getFirstComponent on every access against
+// a reference resolved once and kept in the same Actor as the node, so it cannot outlive the component
+struct ComponentLookupGist : public IGame
+{
+    static constexpr size_t Nodes = 10000;
+    static constexpr size_t Lookups = 1000000;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        auto label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        label->setHorizontalAlign(HorizontalAlign::Center);
+        label->setFontSize(40);
+
+        m_actors.reserve(Nodes);
+        for (size_t i = 0; i < Nodes; ++i)
+        {
+            auto node = make::sptr<Node>(utils::format("actor_%zu", i));
+            node->addComponent<Health>(IComponent::Id("health"));
+            node->addComponent<Speed>(IComponent::Id("speed"));
+            auto& score = node->addComponent<Score>(IComponent::Id("score"));
+            m_actors.push_back({node, &score});
+        }
+
+        std::mt19937 random(5);
+        std::uniform_int_distribution<size_t> nodes(0, Nodes - 1);
+        m_order.resize(Lookups);
+        for (auto& index : m_order)
+        {
+            index = nodes(random);
+        }
+
+        const IComponent::Id score("score");
+        const auto getComponentMs = measure([this, &score](size_t index)
+        {
+            return m_actors[index].node->getComponent<Score>(score).m_value;
+        });
+
+        const auto getFirstMs = measure([this](size_t index)
+        {
+            return m_actors[index].node->getFirstComponent<Score>().m_value;
+        });
+
+        const auto resolvedMs = measure([this](size_t index)
+        {
+            return m_actors[index].score->m_value;
+        });
+
+        label->setText(utils::format("%zu nodes, %zu lookups\nNode::getComponent: %.2f ms\nNode::getFirstComponent: %.2f ms\nresolved once: %.2f ms",
+                                     Nodes, Lookups, getComponentMs, getFirstMs, resolvedMs));
+        W4_LOG_INFO("%zu lookups: Node::getComponent %.2f ms, Node::getFirstComponent %.2f ms, resolved once %.2f ms",
+                    Lookups, getComponentMs, getFirstMs, resolvedMs);
+    }
+
+private:
+    template<typename F>
+    float measure(F&& lookup) const
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        float checksum = 0.f;
+        for (const auto index : m_order)
+        {
+            checksum += lookup(index);
+        }
+        W4_LOG_DEBUG("checksum %f", checksum);
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // the node owns its components: the reference is valid while the actor holds the node and nobody removes the component
+    struct Actor
+    {
+        sptr<Node> node;
+        Score* score;
+    };
+
+    std::vector<Actor> m_actors;
+    std::vector<size_t> m_order;
+};
+
+W4_RUN(ComponentLookupGist)
@@ -0,0 +1,10 @@
+@echo off
+
+rmdir /Q /S  .cmake
+rmdir /Q /S  .cache
+rmdir /Q /S  _out
+rmdir /Q /S  cmake-build-debug
+rmdir /Q /S  cmake-build-release
+rmdir /Q /S  cmake-build-shipping
+
+
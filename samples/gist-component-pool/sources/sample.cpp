@@ -0,0 +1,121 @@
+#include "W4Framework.h"
+
+#include <chrono>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// the same lightweight component spread over the heap and updated virtually, and walked in a ComponentPool
+class HashedSpinner : public core::IComponent
+{
+    W4_COMPONENT(HashedSpinner, core::IComponent)
+    W4_COMPONENT_DISABLE_CLONING
+
+public:
+    void update(float dt) override
+    {
+        m_angle += m_speed * dt;
+    }
+
+    float m_angle = 0.f;
+    float m_speed = 1.f;
+};
+
+class PooledSpinner : public core::IComponent
+{
+    W4_COMPONENT(PooledSpinner, core::IComponent)
+    W4_COMPONENT_DISABLE_CLONING
+    W4_COMPONENT_POOLED
+
+public:
+    void update(float dt) override
+    {
+        m_angle += m_speed * dt;
+    }
+
+    float m_angle = 0.f;
+    float m_speed = 1.f;
+};
+
+struct ComponentPoolGist : public IGame
+{
+    static constexpr size_t Nodes = 500;
+    static constexpr size_t ComponentsPerNode = 100;
+    static constexpr size_t Frames = 100;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        auto label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        label->setHorizontalAlign(HorizontalAlign::Center);
+        label->setFontSize(40);
+
+        for (size_t i = 0; i < Nodes; ++i)
+        {
+            auto node = make::sptr<Node>(utils::format("spinners_%zu", i));
+            for (size_t j = 0; j < ComponentsPerNode; ++j)
+            {
+                auto& spinner = node->addComponent<HashedSpinner>();
+                spinner.m_speed = static_cast<float>(j);
+                m_hashed.push_back(&spinner);
+                node->addComponent<PooledSpinner>().m_speed = static_cast<float>(j);
+            }
+            m_nodes.push_back(node);
+        }
+
+        const auto hashedMs = measure([this](float dt)
+        {
+            for (auto* component : m_hashed)
+            {
+                component->update(dt);
+            }
+        });
+
+        const auto pooledMs = measure([](float dt)
+        {
+            ComponentsSystem::forEach<PooledSpinner>([dt](PooledSpinner& spinner)
+            {
+                spinner.PooledSpinner::update(dt);
+            });
+        });
+
+        const auto inlinedMs = measure([](float dt)
+        {
+            ComponentsSystem::forEach<PooledSpinner>([dt](PooledSpinner& spinner)
+            {
+                spinner.m_angle += spinner.m_speed * dt;
+            });
+        });
+
+        // a handle goes stale when its component is removed, the freed slot is reused by the next one
+        auto& first = m_nodes.front()->getFirstComponent<PooledSpinner>();
+        const auto handle = ComponentsSystem::getHandle(first);
+        const auto id = first.id();
+        m_nodes.front()->removeComponent<PooledSpinner>(id);
+        m_nodes.front()->addComponent<PooledSpinner>();
+        const bool isStale = ComponentsSystem::get(handle) == nullptr;
+
+        const auto count = Nodes * ComponentsPerNode;
+        label->setText(utils::format("%zu components, %zu updates\nheap, virtual: %.2f ms\npooled update: %.2f ms\npooled inlined: %.2f ms\nstale handle: %s",
+                                     count, Frames, hashedMs, pooledMs, inlinedMs, isStale ? "yes" : "no"));
+        W4_LOG_INFO("%zu components x %zu updates: heap %.2f ms, pooled update %.2f ms, pooled inlined %.2f ms",
+                    count, Frames, hashedMs, pooledMs, inlinedMs);
+    }
+
+private:
+    template<typename F>
+    static float measure(F&& update)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (size_t frame = 0; frame < Frames; ++frame)
+        {
+            update(1.f / 60.f);
+        }
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    std::vector<sptr<Node>> m_nodes;
+    std::vector<core::IComponent*> m_hashed;
+};
+
+W4_RUN(ComponentPoolGist)
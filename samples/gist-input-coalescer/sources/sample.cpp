@@ -0,0 +1,94 @@
+#include "W4Framework.h"
+#include "InputCoalescer.h"
+
+W4_USE_UNSTRICT_INTERFACE
+
+// DRAG the cube: its touch moves are merged into one update a frame, the moves left at Touch::End are delivered
+// before the drag ends; the left stick of a gamepad moves it too, read once a frame from the gamepad state
+class GistInputCoalescer : public IGame
+{
+    static constexpr float Speed = 5.f;
+
+    void onStart() override
+    {
+        Render::getScreenCamera()->setWorldTranslation({0, 0, -15});
+
+        m_cube = Mesh::create::cube({2, 2, 2});
+        m_cube->setMaterialInst(Material::getDefaultLambert()->createInstance());
+        Render::getRoot()->addChild(m_cube);
+
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 300));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        event::Touch::Move::subscribe([this](const event::Touch::Move& event)
+        {
+            m_coalescer.onTouchMove(event);
+        });
+        event::Touch::End::subscribe([this](const event::Touch::End& event)
+        {
+            m_coalescer.onTouchEnd(event);
+            if (event.touchId == m_dragId)
+            {
+                m_dragId = NoDrag;
+                ++m_drags;
+            }
+        });
+    }
+
+    void onTouch(const event::Touch::Begin& event) override
+    {
+        m_coalescer.onTouchBegin(event);
+        if (m_dragId == NoDrag)
+        {
+            m_dragId = event.touchId;
+            m_lastPoint = event.point;
+        }
+    }
+
+    void onUpdate(float dt) override
+    {
+        m_coalescer.flushTouchMoves();
+        m_coalescer.flushGamepadAxes([this](size_t axis, float value)
+        {
+            if (axis < m_stick.size())
+            {
+                m_stick[axis] = value;
+            }
+        });
+        m_cube->translateWorld({m_stick[0] * Speed * dt, -m_stick[1] * Speed * dt, 0});
+        m_cube->rotateLocal(Rotator(0, dt, 0));
+
+        m_label->setText(utils::format("raw input events: %zu\nflushed updates: %zu\ndrags: %u",
+                                       m_coalescer.getRawCount(), m_coalescer.getFlushedCount(), m_drags));
+    }
+
+private:
+    static constexpr int NoDrag = -1;
+
+    // once per frame and finger, and right before the Begin or End of the same finger
+    void onTouchMoves(int touchId, const point& point, const std::vector<math::point>&)
+    {
+        if (touchId != m_dragId)
+        {
+            return;
+        }
+        const auto& size = Platform::getSize();
+        const auto scale = 10.f / size.h;
+        m_cube->translateWorld({-(point.x - m_lastPoint.x) * scale, -(point.y - m_lastPoint.y) * scale, 0});
+        m_lastPoint = point;
+    }
+
+    InputCoalescer m_coalescer{[this](int touchId, const point& point, const std::vector<math::point>& points)
+    {
+        onTouchMoves(touchId, point, points);
+    }};
+    sptr<Mesh> m_cube;
+    sptr<Label> m_label;
+    std::array<float, 2> m_stick = {0.f, 0.f};
+    int m_dragId = NoDrag;
+    point m_lastPoint;
+    uint32_t m_drags = 0;
+};
+
+W4_RUN(GistInputCoalescer)
@@ -0,0 +1,84 @@
+#include "W4Framework.h"
+
+#include <chrono>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// scalar vs SIMD throughput of the w4::math kernels, build with W4_WASM_SIMD=1 to get the simd128 backend
+struct MathSimdGist : public IGame
+{
+    static constexpr size_t Count = 10000;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        m_label->setFontSize(40);
+
+        m_lhs.resize(Count * 16);
+        m_rhs.resize(Count * 16);
+        m_out.resize(Count * 16);
+        for (auto& v: m_lhs) v = random<float>(-1.f, 1.f);
+        for (auto& v: m_rhs) v = random<float>(-1.f, 1.f);
+    }
+
+    void onUpdate(float) override
+    {
+        const float* a = m_lhs.data();
+        const float* b = m_rhs.data();
+        float* out = m_out.data();
+
+        m_mat4[0] += measure([&] { for (size_t i = 0; i < Count; ++i) simd::scalar::mulMat4(a + i * 16, b + i * 16, out + i * 16); });
+        m_mat4[1] += measure([&] { simd::mulMat4Batch(a, b, out, Count); });
+
+        m_vec4[0] += measure([&] { for (size_t i = 0; i < Count * 4; ++i) simd::scalar::mulMat4Vec4(a, b + i * 4, out + i * 4); });
+        m_vec4[1] += measure([&] { simd::mulMat4Vec4Batch(a, b, out, Count * 4); });
+
+        m_compose[0] += measure([&] { for (size_t i = 0; i < Count; ++i) simd::scalar::mulMat4(a, b + i * 16, out + i * 16); });
+        m_compose[1] += measure([&] { simd::composeMat4Batch(a, b, out, Count); });
+
+        m_quat[0] += measure([&] { for (size_t i = 0; i < Count * 4; ++i) simd::scalar::mulQuat(a + i * 4, b + i * 4, out + i * 4); });
+        m_quat[1] += measure([&] { for (size_t i = 0; i < Count * 4; ++i) simd::mulQuat(a + i * 4, b + i * 4, out + i * 4); });
+
+        if (++m_frames == 60)
+        {
+            auto line = [this](const char* name, const float* t)
+            {
+                return utils::format("%s: %.3f / %.3f ms (x%.2f)\n", name, t[0] / m_frames, t[1] / m_frames, t[1] > 0 ? t[0] / t[1] : 0.f);
+            };
+            auto text = utils::format("backend %s, %zu items, scalar / simd\n", W4_MATH_SIMD, Count)
+                      + line("mat4 x mat4", m_mat4)
+                      + line("mat4 x vec4", m_vec4)
+                      + line("compose", m_compose)
+                      + line("quat x quat", m_quat);
+            m_label->setText(text);
+            W4_LOG_INFO("%s", text.c_str());
+            m_mat4[0] = m_mat4[1] = m_vec4[0] = m_vec4[1] = m_compose[0] = m_compose[1] = m_quat[0] = m_quat[1] = 0;
+            m_frames = 0;
+        }
+    }
+
+private:
+    template<typename F>
+    static float measure(F&& f)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        f();
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    sptr<gui::Label> m_label;
+    std::vector<float> m_lhs;
+    std::vector<float> m_rhs;
+    std::vector<float> m_out;
+
+    float m_mat4[2] = {};
+    float m_vec4[2] = {};
+    float m_compose[2] = {};
+    float m_quat[2] = {};
+    int m_frames = 0;
+};
+
+W4_RUN(MathSimdGist)
@@ -0,0 +1,4 @@
+@echo off
+
+w4.cmd build All
+
@@ -0,0 +1,58 @@
+#include "W4Framework.h"
+
+W4_USE_UNSTRICT_INTERFACE
+
+// levels.pak is a chunked w4pack (build-res.py with W4_PACK_CHUNKED=1) of 16 level maps shipped as a plain resource,
+// PackageReader decodes only the 256 KB blocks the shown level spans; TAP for the next level
+class GistPackageReader : public IGame
+{
+    void onStart() override
+    {
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 600));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        if (!m_reader.open(filesystem::open("levels.pak")))
+        {
+            m_label->setText("levels.pak is not a valid w4pack");
+            return;
+        }
+        showLevel();
+    }
+
+    void onTouch(const event::Touch::Begin&) override
+    {
+        if (!m_reader.getFiles().empty())
+        {
+            m_level = (m_level + 1) % m_reader.getFiles().size();
+            showLevel();
+        }
+    }
+
+private:
+    void showLevel()
+    {
+        const auto& file = m_reader.getFiles()[m_level];
+        if (!m_reader.read(file, m_data))
+        {
+            m_label->setText(utils::format("failed to read %s", file.name.c_str()));
+            return;
+        }
+
+        // the first line of a level is its header, '#' cells are walls
+        const std::string header(m_data.begin(), std::find(m_data.begin(), m_data.end(), '\n'));
+        const auto walls = std::count(m_data.begin(), m_data.end(), '#');
+        const auto& stats = m_reader.getStats();
+        m_label->setText(utils::format("%s\n%s, %zu walls, %zu bytes\n%zu files in %s pack\nblocks decoded: %u, cache hits: %u",
+                                       file.name.c_str(), header.c_str(), static_cast<size_t>(walls), m_data.size(),
+                                       m_reader.getFiles().size(), m_reader.isChunked() ? "a chunked" : "a legacy",
+                                       stats.blocksDecoded, stats.cacheHits));
+    }
+
+    sptr<Label> m_label;
+    PackageReader m_reader;
+    std::vector<uint8_t> m_data;
+    size_t m_level = 0;
+};
+
+W4_RUN(GistPackageReader)
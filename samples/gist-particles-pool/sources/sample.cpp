@@ -0,0 +1,86 @@
+#include "W4Framework.h"
+
+#include <chrono>
+#include <random>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// hit sparks: a dozen short effects a second from pooled simulations, merged into a batch per texture and blend;
+// ParticlesBatcher only builds the batches, drawing them takes the app's own buffer and material, so nothing is drawn here
+struct ParticlesPoolGist : public IGame
+{
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        m_label->setFontSize(40);
+
+        m_sparks.maxParticles = 48;
+        m_sparks.angle = {HALF_PI, PI};
+        m_sparks.duration = 0.1f;
+        m_sparks.startColor = {{1.f, 0.9f, 0.5f, 1.f}, {0.f, 0.1f, 0.1f, 0.f}};
+        m_sparks.endColor = {{1.f, 0.3f, 0.f, 0.f}, {0.f, 0.f, 0.f, 0.f}};
+        m_sparks.startSize = {0.1f, 0.03f};
+        m_sparks.endSize = {0.02f, 0.f};
+        m_sparks.particleLifeSpan = {0.4f, 0.15f};
+        m_sparks.gravityParameters.gravity = {0.f, -9.8f};
+        m_sparks.gravityParameters.startSpeed = {4.f, 1.5f};
+        m_sparks.gravityParameters.rotationIsDir = true;
+
+        // same texture, additive: a second batch
+        m_flashes = m_sparks;
+        m_flashes.maxParticles = 8;
+        m_flashes.blendFunc = {BlendFactor::SRC_ALPHA, BlendFactor::ONE};
+        m_flashes.gravityParameters.startSpeed = {0.5f, 0.2f};
+        m_flashes.startSize = {0.6f, 0.2f};
+
+        event::Touch::Begin::subscribe([this](const Touch::Begin&)
+        {
+            for (size_t i = 0; i < 20; ++i)
+            {
+                spawnHit();
+            }
+        });
+    }
+
+    void onUpdate(float dt) override
+    {
+        m_spawnCounter += dt * 12.f;
+        for (; m_spawnCounter >= 1.f; m_spawnCounter -= 1.f)
+        {
+            spawnHit();
+        }
+
+        auto& manager = ParticlesManager::instance();
+        const auto start = std::chrono::high_resolution_clock::now();
+        manager.update(dt);
+        const auto ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        const auto stats = manager.getStats();
+        m_label->setText(utils::format("effects: %u, particles: %u\nbatches: %u\npooled simulations: %u\nupdate: %.3f ms",
+                                       stats.effects, stats.particles, stats.batches, stats.pooledSimulations, ms));
+    }
+
+private:
+    void spawnHit()
+    {
+        std::uniform_real_distribution<float> position(-3.f, 3.f);
+        auto world = mat4::identity;
+        world.data[12] = position(m_random);
+        world.data[13] = position(m_random);
+
+        auto& manager = ParticlesManager::instance();
+        manager.play(m_sparks, world);
+        manager.play(m_flashes, world);
+    }
+
+    sptr<Label> m_label;
+    ParticlesEmitterParameters m_sparks{};
+    ParticlesEmitterParameters m_flashes{};
+    std::mt19937 m_random{3};
+    float m_spawnCounter = 0.f;
+};
+
+W4_RUN(ParticlesPoolGist)
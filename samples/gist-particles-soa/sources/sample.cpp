@@ -0,0 +1,116 @@
+#include "W4Framework.h"
+
+#include <chrono>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// SoA particle simulation: 48 emitters of 2000 particles, half GRAVITY half RADIUS, vertex stream included,
+// against the CPU side of ParticlesGpuStream, which only writes the spawned particles; no material here compiles
+// its shader, so the stream is timed but not drawn
+struct ParticlesSoaGist : public IGame
+{
+    static constexpr size_t Emitters = 48;
+    static constexpr uint32_t ParticlesPerEmitter = 2000;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        m_label->setFontSize(40);
+
+        ParticlesEmitterParameters parameters{};
+        parameters.maxParticles = ParticlesPerEmitter;
+        parameters.angle = {HALF_PI, 0.4f};
+        parameters.duration = -1.f;
+        parameters.startColor = {{1.f, 0.6f, 0.2f, 1.f}, {0.f, 0.1f, 0.1f, 0.f}};
+        parameters.endColor = {{0.2f, 0.f, 0.f, 0.f}, {0.f, 0.f, 0.f, 0.f}};
+        parameters.startSize = {8.f, 2.f};
+        parameters.endSize = {2.f, 1.f};
+        parameters.sourcePosition = {{0.f, 0.f}, {4.f, 4.f}};
+        parameters.startRotation = {0.f, PI};
+        parameters.endRotation = {PI, PI};
+        parameters.particleLifeSpan = {2.f, 0.5f};
+        parameters.gravityParameters.gravity = {0.f, -20.f};
+        parameters.gravityParameters.startSpeed = {60.f, 15.f};
+        parameters.gravityParameters.radialAcceleration = {5.f, 2.f};
+        parameters.gravityParameters.tangentialAcceleration = {10.f, 5.f};
+        parameters.radiusParameters.maxRadius = {80.f, 10.f};
+        parameters.radiusParameters.minRadius = {5.f, 2.f};
+        parameters.radiusParameters.rotatePerSecond = {1.5f, 0.5f};
+
+        m_simulations.resize(Emitters);
+        m_streams.resize(Emitters);
+        for (size_t i = 0; i < Emitters; ++i)
+        {
+            parameters.emitterType = i % 2 ? ParticlesEmitterParameters::EmitterType::RADIUS : ParticlesEmitterParameters::EmitterType::GRAVITY;
+            m_simulations[i].setParameters(parameters);
+            m_simulations[i].setSeed(static_cast<uint32_t>(i + 1));
+            m_simulations[i].start();
+
+            // no radial and tangential acceleration on the GPU
+            auto gpuParameters = parameters;
+            gpuParameters.gravityParameters.radialAcceleration = {0.f, 0.f};
+            gpuParameters.gravityParameters.tangentialAcceleration = {0.f, 0.f};
+            W4_ASSERT(ParticlesGpuStream::isSupported(gpuParameters));
+            m_streams[i].setParameters(gpuParameters);
+            m_streams[i].setSeed(static_cast<uint32_t>(i + 1));
+            m_streams[i].start();
+        }
+        // one vertex array reused every frame, as the emitter dynamic buffer is
+        m_vertices.resize(ParticlesPerEmitter * ParticlesSimulation::VerticesPerParticle);
+    }
+
+    void onUpdate(float dt) override
+    {
+        size_t particles = 0;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (auto& simulation : m_simulations)
+        {
+            simulation.update(dt, mat4::identity);
+            simulation.writeVertices(m_vertices.data(), 0.001f);
+            particles += simulation.size();
+        }
+        const auto ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        m_time += dt;
+        size_t spawned = 0;
+        const auto gpuStart = std::chrono::high_resolution_clock::now();
+        for (auto& stream : m_streams)
+        {
+            stream.update(dt, m_time, mat4::identity);
+            spawned += stream.getSpawnedCount();
+            stream.clearDirty();
+        }
+        const auto gpuMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - gpuStart).count();
+
+        // averaged over a second
+        m_accumulatedMs += ms;
+        m_accumulatedGpuMs += gpuMs;
+        m_accumulatedTime += dt;
+        ++m_frames;
+        if (m_accumulatedTime >= 1.f)
+        {
+            m_label->setText(utils::format("%zu emitters, %zu particles\nCPU simulation: %.2f ms\nGPU stream, CPU side: %.3f ms, %zu spawned",
+                                           Emitters, particles, m_accumulatedMs / m_frames, m_accumulatedGpuMs / m_frames, spawned));
+            m_accumulatedMs = 0.f;
+            m_accumulatedGpuMs = 0.f;
+            m_accumulatedTime = 0.f;
+            m_frames = 0;
+        }
+    }
+
+private:
+    sptr<Label> m_label;
+    std::vector<ParticlesSimulation> m_simulations;
+    std::vector<ParticlesVertexFormat> m_vertices;
+    std::vector<ParticlesGpuStream> m_streams;
+    float m_time = 0.f;
+    float m_accumulatedMs = 0.f;
+    float m_accumulatedGpuMs = 0.f;
+    float m_accumulatedTime = 0.f;
+    uint32_t m_frames = 0;
+};
+
+W4_RUN(ParticlesSoaGist)
@@ -0,0 +1,217 @@
+#include "W4Framework.h"
+#include "SkeletonPose.h"
+#include "AnimationLod.h"
+
+#include <chrono>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// N characters x M bones, two blended animations per character:
+// per bone mat4 sampling with recursive propagation vs the SoA pose pipeline, serial and on PoseWorkers,
+// and the SoA pipeline throttled by AnimationLod for a crowd standing 1 to 128 units away
+struct SkeletalPoseGist : public IGame
+{
+    static constexpr size_t Characters = 128;
+    static constexpr size_t Bones = 64;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        m_label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        m_label->setHorizontalAlign(HorizontalAlign::Center);
+        m_label->setFontSize(48);
+
+        // a spine of 8 bones with limbs hanging off it
+        m_parents.resize(Bones);
+        m_children.resize(Bones);
+        for (size_t i = 0; i < Bones; ++i)
+        {
+            m_parents[i] = i == 0 ? SkeletonPose::NoParent : static_cast<int32_t>(i < 8 ? i - 1 : (i % 8 == 0 ? i / 8 : i - 1));
+            if (m_parents[i] != SkeletonPose::NoParent)
+            {
+                m_children[m_parents[i]].push_back(i);
+            }
+        }
+        m_mapping.resize(Bones);
+        for (size_t i = 0; i < Bones; ++i)
+        {
+            m_mapping[i] = {static_cast<BoneIndex>(i), static_cast<BoneIndex>(i)};
+        }
+        m_bindPose.resize(Bones);
+        for (size_t i = 0; i < Bones; ++i)
+        {
+            m_bindPose.set(i, Transform(Rotator(0, 0, 0), {0, 1, 0}, {1, 1, 1}));
+        }
+
+        m_characters.resize(Characters);
+        for (size_t c = 0; c < Characters; ++c)
+        {
+            auto& character = m_characters[c];
+            character.pose.setHierarchy(m_parents);
+            character.lodPose.setHierarchy(m_parents);
+            character.legacyWorld.resize(Bones);
+            // near: every frame, mid: every 2nd frame and the first half of the bones, far: every 4th frame and the first quarter
+            character.lod.setLevels({{0.f, 0.f, 1, resources::maxBonesCount},
+                                     {32.f, 0.f, 2, static_cast<resources::BoneIndex>(Bones / 2)},
+                                     {64.f, 0.f, 4, static_cast<resources::BoneIndex>(Bones / 4)}});
+            character.lod.setPhase(static_cast<uint32_t>(c));
+        }
+        PoseWorkers::setThreadsCount(PoseWorkers::getDefaultThreadsCount());
+    }
+
+    void onUpdate(float dt) override
+    {
+        using clock = std::chrono::high_resolution_clock;
+        m_time += dt;
+        float checksum = 0;
+
+        // per bone path: one mat4 per animation and bone, blended as matrices, recursive world pass
+        auto start = clock::now();
+        for (size_t c = 0; c < Characters; ++c)
+        {
+            auto& character = m_characters[c];
+            for (size_t i = 0; i < Bones; ++i)
+            {
+                if (m_parents[i] == SkeletonPose::NoParent)
+                {
+                    legacyBone(character, i, mat4::identity, c);
+                }
+            }
+            checksum += character.legacyWorld.back().data[12];
+        }
+        const auto legacy = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+
+        start = clock::now();
+        for (size_t c = 0; c < Characters; ++c)
+        {
+            evaluate(m_characters[c], c, Bones, 0.f);
+        }
+        const auto serial = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+
+        start = clock::now();
+        PoseWorkers::run(Characters, [this](size_t c) { evaluate(m_characters[c], c, Bones, 0.f); });
+        const auto parallel = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+        for (auto& character: m_characters)
+        {
+            checksum -= character.pose.getWorldMatrices().back().data[12];
+        }
+
+        // LOD path: a character is sampled on its due frames only, lookAhead frames ahead, and shows the interpolated pose
+        start = clock::now();
+        AnimationLod::beginFrame();
+        for (size_t c = 0; c < Characters; ++c)
+        {
+            auto& character = m_characters[c];
+            const auto decision = character.lod.update(static_cast<float>(c + 1), 1.f, true, m_frameIndex);
+            if (decision.action == AnimationLod::Action::Skip)
+            {
+                continue;
+            }
+            if (decision.action == AnimationLod::Action::Evaluate)
+            {
+                const auto bones = std::min<size_t>(Bones, decision.maxBones);
+                evaluate(character, c, bones, decision.lookAhead * dt);
+                AnimationLod::addEvaluatedBones(static_cast<uint32_t>(bones));
+                character.interpolator.push(character.blended);
+            }
+            character.lodPose.evaluate(character.interpolator.at(decision.alpha), mat4::identity);
+            checksum += character.lodPose.getWorldMatrices().back().data[12];
+        }
+        const auto lod = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+        const auto& counters = AnimationLod::getFrameCounters();
+        m_evaluated += counters.evaluated;
+        m_interpolated += counters.interpolated;
+        ++m_frameIndex;
+
+        m_legacy += legacy;
+        m_serial += serial;
+        m_parallel += parallel;
+        m_lod += lod;
+        if (++m_frames == 60)
+        {
+            m_label->setText(utils::format("%zu x %zu bones\nper bone %.3f ms\nSoA %.3f ms\nSoA, %zu workers %.3f ms\nSoA with LOD %.3f ms\n%.1f evaluated, %.1f interpolated",
+                                           Characters, Bones, m_legacy / m_frames, m_serial / m_frames, PoseWorkers::getThreadsCount(), m_parallel / m_frames,
+                                           m_lod / m_frames, static_cast<float>(m_evaluated) / m_frames, static_cast<float>(m_interpolated) / m_frames));
+            W4_LOG_INFO("%zu x %zu bones: per bone %.3f ms, SoA %.3f ms, SoA on %zu workers %.3f ms, SoA with LOD %.3f ms (checksum %f)",
+                        Characters, Bones, m_legacy / m_frames, m_serial / m_frames, PoseWorkers::getThreadsCount(), m_parallel / m_frames, m_lod / m_frames, checksum);
+            m_legacy = m_serial = m_parallel = m_lod = 0;
+            m_evaluated = m_interpolated = 0;
+            m_frames = 0;
+        }
+    }
+
+private:
+    struct Character
+    {
+        LocalPose walk;
+        LocalPose wave;
+        LocalPose blended;
+        PoseBlender blender;
+        SkeletonPose pose;
+        std::vector<mat4> legacyWorld;
+        AnimationLod lod;
+        PoseInterpolator interpolator;
+        SkeletonPose lodPose;
+    };
+
+    // stands for a track lookup
+    Transform sample(size_t bone, size_t character, float phase, float ahead = 0.f) const
+    {
+        const auto t = m_time + ahead + character * 0.1f + phase;
+        return Transform(Rotator(std::sin(t + bone) * 0.3f, 0, std::cos(t) * 0.2f), {0, 1, 0}, {1, 1, 1});
+    }
+
+    void legacyBone(Character& character, size_t bone, const mat4& parent, size_t c)
+    {
+        const auto walk = sample(bone, c, 0.f).getMatrix();
+        const auto wave = sample(bone, c, 1.f).getMatrix();
+        mat4 local;
+        for (size_t k = 0; k < 16; ++k)
+        {
+            local.data[k] = walk.data[k] * 0.7f + wave.data[k] * 0.3f;
+        }
+        character.legacyWorld[bone] = parent * local;
+        for (auto child: m_children[bone])
+        {
+            legacyBone(character, child, character.legacyWorld[bone], c);
+        }
+    }
+
+    // samples the first bones at ahead seconds from now, the others keep their last local transforms
+    void evaluate(Character& character, size_t c, size_t bones, float ahead) const
+    {
+        character.walk.resize(Bones);
+        character.wave.resize(Bones);
+        for (size_t i = 0; i < bones; ++i)
+        {
+            character.walk.set(i, sample(i, c, 0.f, ahead));
+            character.wave.set(i, sample(i, c, 1.f, ahead));
+        }
+        character.blender.begin(Bones);
+        character.blender.add(character.walk, m_mapping, 0.7f);
+        character.blender.add(character.wave, m_mapping, 0.3f);
+        character.blender.finish(m_bindPose, character.blended);
+        character.pose.evaluate(character.blended, mat4::identity);
+    }
+
+    sptr<gui::Label> m_label;
+
+    std::vector<int32_t> m_parents;
+    std::vector<std::vector<size_t>> m_children;
+    PoseBlender::Mapping m_mapping;
+    LocalPose m_bindPose;
+    std::vector<Character> m_characters;
+
+    float m_time = 0;
+    float m_legacy = 0;
+    float m_serial = 0;
+    float m_parallel = 0;
+    float m_lod = 0;
+    uint32_t m_evaluated = 0;
+    uint32_t m_interpolated = 0;
+    uint64_t m_frameIndex = 0;
+    int m_frames = 0;
+};
+
+W4_RUN(SkeletalPoseGist)
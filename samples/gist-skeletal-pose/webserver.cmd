@@ -0,0 +1,3 @@
+@echo off
+
+start python.exe -m http.server --directory _out 80
\ No newline at end of file
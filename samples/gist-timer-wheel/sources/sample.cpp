@@ -0,0 +1,78 @@
+#include "W4Framework.h"
+
+#include <chrono>
+#include <random>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// 100k pending cooldowns: every task polled each frame against a timer wheel touching the expired ones only
+struct TimerWheelGist : public IGame
+{
+    static constexpr size_t Timers = 100000;
+    static constexpr size_t Frames = 600;
+    static constexpr float FrameTime = 1.f / 60.f;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        auto label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        label->setHorizontalAlign(HorizontalAlign::Center);
+        label->setFontSize(40);
+
+        std::mt19937 random(17);
+        std::uniform_real_distribution<float> periods(1.f, 60.f);
+        std::vector<float> cooldowns(Timers);
+        for (auto& cooldown : cooldowns)
+        {
+            cooldown = periods(random);
+        }
+
+        size_t polledFired = 0;
+        TaskPool<void (float)> pool;
+        for (const auto cooldown : cooldowns)
+        {
+            pool.addCallable([&polledFired, cooldown, elapsed = 0.f](float dt) mutable
+            {
+                elapsed += dt;
+                if (elapsed < cooldown)
+                {
+                    return true;
+                }
+                ++polledFired;
+                return false;
+            });
+        }
+        const auto polledMs = measure([&pool] { pool.emit(FrameTime); });
+
+        size_t wheelFired = 0;
+        TimerWheel wheel;
+        for (const auto cooldown : cooldowns)
+        {
+            wheel.add(cooldown, [&wheelFired]
+            {
+                ++wheelFired;
+                return true;
+            });
+        }
+        const auto wheelMs = measure([&wheel] { wheel.advance(FrameTime); });
+
+        label->setText(utils::format("%zu timers, %zu frames\npolled: %.2f ms, %zu fired\ntimer wheel: %.2f ms, %zu fired\n%zu still pending",
+                                     Timers, Frames, polledMs, polledFired, wheelMs, wheelFired, wheel.size()));
+        W4_LOG_INFO("%zu timers x %zu frames: polled %.2f ms, timer wheel %.2f ms", Timers, Frames, polledMs, wheelMs);
+    }
+
+private:
+    template<typename F>
+    static float measure(F&& frame)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < Frames; ++i)
+        {
+            frame();
+        }
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+};
+
+W4_RUN(TimerWheelGist)
@@ -0,0 +1,116 @@
+#include "W4Framework.h"
+#include "CompressedTrack.h"
+
+#include <chrono>
+#include <random>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// memory and decode speed of plain tracks vs their compressed copies: 64 bones x (translation, rotation) tracks of 30 fps keys
+struct TrackCompressionGist : public IGame
+{
+    static constexpr size_t Bones = 64;
+    static constexpr size_t Keys = 30 * 20;
+    static constexpr size_t Samples = 200000;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        auto label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        label->setHorizontalAlign(HorizontalAlign::Center);
+        label->setFontSize(40);
+
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> angle(-PI, PI);
+        for (size_t bone = 0; bone < Bones; ++bone)
+        {
+            auto translation = make::sptr<TrackVec3>(utils::format("translation_%zu", bone));
+            auto rotation = make::sptr<TrackRotator>(utils::format("rotation_%zu", bone));
+            const auto phase = angle(random);
+            for (size_t key = 0; key < Keys; ++key)
+            {
+                const auto time = static_cast<float>(key) / 30.f;
+                translation->addValue({time, {std::sin(time + phase), 1.f, std::cos(time)}, InterpType::LERP, {}});
+                rotation->addValue({time, Rotator(std::sin(time * 2.f + phase), std::cos(time), 0.f), InterpType::LERP, {}});
+            }
+            m_translations.push_back(translation);
+            m_rotations.push_back(rotation);
+        }
+
+        size_t plainBytes = 0;
+        size_t compressedBytes = 0;
+        for (size_t bone = 0; bone < Bones; ++bone)
+        {
+            m_compressedTranslations.push_back(CompressedTrack<vec3>::compress(m_translations[bone]->getValues()));
+            m_compressedRotations.push_back(CompressedTrack<Rotator>::compress(m_rotations[bone]->getValues()));
+            plainBytes += m_translations[bone]->getMemorySize() + m_rotations[bone]->getMemorySize();
+            compressedBytes += m_compressedTranslations.back().getMemorySize() + m_compressedRotations.back().getMemorySize();
+        }
+
+        const auto plainMs = measure(m_translations, m_rotations);
+        const auto compressedMs = measure(m_compressedTranslations, m_compressedRotations);
+        const auto reference = sampleAll(m_translations, m_rotations);
+        const auto compressed = sampleAll(m_compressedTranslations, m_compressedRotations);
+
+        float maxError = 0.f;
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            maxError = std::max(maxError, std::fabs(reference[i] - compressed[i]));
+        }
+
+        label->setText(utils::format("%zu tracks x %zu keys\nplain: %zu KiB, %.2f ms\ncompressed: %zu KiB, %.2f ms\nmax error %f",
+                                     Bones * 2, Keys, plainBytes / 1024, plainMs, compressedBytes / 1024, compressedMs, maxError));
+        W4_LOG_INFO("%zu tracks x %zu keys: plain %zu bytes %.2f ms, compressed %zu bytes %.2f ms per %zu samples, max error %f",
+                    Bones * 2, Keys, plainBytes, plainMs, compressedBytes, compressedMs, Samples, maxError);
+    }
+
+private:
+    template<typename T>
+    static const CompressedTrack<T>& get(const CompressedTrack<T>& track) { return track; }
+    template<typename T>
+    static const T& get(const sptr<T>& track) { return *track; }
+
+    template<typename Translations, typename Rotations>
+    float measure(const Translations& translations, const Rotations& rotations) const
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        float checksum = 0.f;
+        const auto duration = m_rotations.front()->getDuration();
+        for (size_t i = 0; i < Samples; ++i)
+        {
+            const auto bone = i % Bones;
+            const auto time = duration * static_cast<float>(i) / Samples;
+            checksum += get(translations[bone]).sample(time).x + get(rotations[bone]).sample(time).quaternion.w;
+        }
+        W4_LOG_DEBUG("checksum %f", checksum);
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    template<typename Translations, typename Rotations>
+    std::vector<float> sampleAll(const Translations& translations, const Rotations& rotations) const
+    {
+        std::vector<float> result;
+        const auto duration = m_rotations.front()->getDuration();
+        for (size_t bone = 0; bone < Bones; ++bone)
+        {
+            for (float time = 0.f; time < duration; time += 0.37f)
+            {
+                const auto translation = get(translations[bone]).sample(time);
+                const auto rotation = get(rotations[bone]).sample(time).quaternion;
+                result.insert(result.end(), {translation.x, translation.y, translation.z});
+                // q and -q are the same rotation
+                const auto sign = rotation.w < 0.f ? -1.f : 1.f;
+                result.insert(result.end(), {rotation.x * sign, rotation.y * sign, rotation.z * sign, rotation.w * sign});
+            }
+        }
+        return result;
+    }
+
+    std::vector<sptr<TrackVec3>> m_translations;
+    std::vector<sptr<TrackRotator>> m_rotations;
+    std::vector<CompressedTrack<vec3>> m_compressedTranslations;
+    std::vector<CompressedTrack<Rotator>> m_compressedRotations;
+};
+
+W4_RUN(TrackCompressionGist)
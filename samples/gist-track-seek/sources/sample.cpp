@@ -0,0 +1,90 @@
+#include "W4Framework.h"
+
+#include <chrono>
+#include <random>
+
+W4_USE_UNSTRICT_INTERFACE
+
+// random access lookups on a long track: binary search, a seek index and an accessor jumping around
+struct TrackSeekGist : public IGame
+{
+    static constexpr size_t Keys = 30 * 60 * 10;
+    static constexpr size_t Samples = 1000000;
+
+    void onStart() override
+    {
+        gui::createWidget<Label>(nullptr, "CLICK ON [?] FOR CODE VIEW ", ivec2(540, 1800));
+
+        auto label = gui::createWidget<Label>(nullptr, "", ivec2(540, 900));
+        label->setHorizontalAlign(HorizontalAlign::Center);
+        label->setFontSize(40);
+
+        // 10 minutes at 30 fps with some jitter, as baked from a DCC tool
+        std::mt19937 random(11);
+        std::uniform_real_distribution<float> jitter(0.f, 0.01f);
+        m_track = make::sptr<TrackVec3>("seek");
+        for (size_t key = 0; key < Keys; ++key)
+        {
+            const auto time = static_cast<float>(key) / 30.f + jitter(random);
+            m_track->addValue({time, {std::sin(time), std::cos(time), time}, InterpType::LERP, {}});
+        }
+
+        std::uniform_real_distribution<float> times(0.f, m_track->getDuration());
+        m_times.resize(Samples);
+        for (auto& time : m_times)
+        {
+            time = times(random);
+        }
+
+        const auto binarySearchMs = measure([this](float time) { return m_track->sample(time); });
+
+        // a standalone index over the key times, rebuilt by its owner when the keys change
+        TrackSeekIndex index;
+        const auto getTime = [this](size_t key) { return m_track->getKeyTime(key); };
+        index.build(m_track->getValuesCount(), getTime);
+        const auto seekIndexMs = measure([this, &index, &getTime](float time)
+        {
+            const auto key = std::min(std::max<size_t>(index.upperBound(time, getTime), 1) - 1, m_track->getValuesCount() - 1);
+            return m_track->getKey(key).value;
+        });
+
+        auto accessor = m_track->createAccessor();
+        const auto accessorMs = measure([&accessor](float time)
+        {
+            accessor->updateTime(time);
+            return accessor->getValue();
+        });
+
+        // backward playback, one frame per update
+        const auto backwardMs = measure([this, &accessor, step = 0](float) mutable
+        {
+            const auto duration = m_track->getDuration();
+            accessor->updateTime(duration - std::fmod(static_cast<float>(step++) / 60.f, duration));
+            return accessor->getValue();
+        });
+
+        label->setText(utils::format("%zu keys, %zu random samples\nbinary search: %.2f ms\nseek index: %.2f ms\naccessor seeks: %.2f ms\naccessor backward: %.2f ms",
+                                     Keys, Samples, binarySearchMs, seekIndexMs, accessorMs, backwardMs));
+        W4_LOG_INFO("%zu keys, %zu samples: binary search %.2f ms, seek index %.2f ms, accessor seeks %.2f ms, accessor backward %.2f ms",
+                    Keys, Samples, binarySearchMs, seekIndexMs, accessorMs, backwardMs);
+    }
+
+private:
+    template<typename F>
+    float measure(F&& sample) const
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        float checksum = 0.f;
+        for (const auto time : m_times)
+        {
+            checksum += sample(time).z;
+        }
+        W4_LOG_DEBUG("checksum %f", checksum);
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    sptr<TrackVec3> m_track;
+    std::vector<float> m_times;
+};
+
+W4_RUN(TrackSeekGist)